@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <arch.h>
@@ -59,15 +60,76 @@ uintptr_t page_align(uintptr_t value, unsigned dir)
 	return value;
 }
 
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+/*******************************************************************************
+ * Report the time spent reading an image and the resulting throughput, given
+ * the system counter value sampled before the read.
+ ******************************************************************************/
+static void report_load_throughput(unsigned int image_id, size_t size,
+				   uint64_t start_cnt)
+{
+	uint64_t freq = read_cntfrq_el0();
+	uint64_t cnt = read_cntpct_el0() - start_cnt;
+
+	if ((freq == 0U) || (cnt == 0U)) {
+		return;
+	}
+
+	INFO("Image id=%u read: %zu bytes in %llu us (%llu KiB/s)\n",
+	     image_id, size, (unsigned long long)((cnt * 1000000U) / freq),
+	     (unsigned long long)(((size * freq) / cnt) / 1024U));
+}
+#endif
+
+#if TRUSTED_BOARD_BOOT && (LOAD_IMAGE_HASH_CHUNK_SIZE != 0)
+/*******************************************************************************
+ * Read an image by chunks of LOAD_IMAGE_HASH_CHUNK_SIZE bytes and hash each
+ * chunk as soon as it is read, while it is still in the data cache, so that
+ * the authentication does not need to read the whole image again.
+ ******************************************************************************/
+static int read_and_hash_image(uintptr_t image_handle, uintptr_t image_base,
+			       size_t image_size, size_t *bytes_read)
+{
+	size_t chunk_size;
+	size_t chunk_read;
+	int io_result;
+
+	*bytes_read = 0U;
+
+	while (*bytes_read < image_size) {
+		chunk_size = MIN(image_size - *bytes_read,
+				 (size_t)LOAD_IMAGE_HASH_CHUNK_SIZE);
+
+		io_result = io_read(image_handle, image_base + *bytes_read,
+				    chunk_size, &chunk_read);
+		if (io_result != 0) {
+			return io_result;
+		}
+
+		if (chunk_read == 0U) {
+			break;
+		}
+
+		auth_mod_hash_stream_update((void *)(image_base + *bytes_read),
+					    (unsigned int)chunk_read);
+		*bytes_read += chunk_read;
+	}
+
+	return 0;
+}
+#endif
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
- * an image ID and extents of free memory.
+ * an image ID and extents of free memory. If hash_stream is true, the image
+ * data is passed to the authentication module as it is read.
  *
  * If the load is successful then the image information is updated.
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      bool hash_stream)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
@@ -76,6 +138,9 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 	size_t image_size;
 	size_t bytes_read;
 	int io_result;
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+	uint64_t start_cnt;
+#endif
 
 	assert(image_data != NULL);
 	assert(image_data->h.version >= VERSION_2);
@@ -123,11 +188,26 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+	start_cnt = read_cntpct_el0();
+#endif
+#if TRUSTED_BOARD_BOOT && (LOAD_IMAGE_HASH_CHUNK_SIZE != 0)
+	if (hash_stream) {
+		io_result = read_and_hash_image(image_handle, image_base,
+						image_size, &bytes_read);
+	} else
+#endif
+	{
+		io_result = io_read(image_handle, image_base, image_size,
+				    &bytes_read);
+	}
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+	report_load_throughput(image_id, image_size, start_cnt);
+#endif
 
 	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, image_base,
 	     (uintptr_t)(image_base + image_size));
@@ -154,6 +234,7 @@ static int load_auth_image_recursive(unsigned int image_id,
 {
 	int rc;
 	unsigned int parent_id;
+	bool hash_stream;
 
 	/* Use recursion to authenticate parent images */
 	rc = auth_mod_get_parent_id(image_id, &parent_id);
@@ -164,9 +245,16 @@ static int load_auth_image_recursive(unsigned int image_id,
 		}
 	}
 
-	/* Load the image */
-	rc = load_image(image_id, image_data);
+	/* Load the image, hashing it on the fly when possible */
+#if LOAD_IMAGE_HASH_CHUNK_SIZE != 0
+	hash_stream = (auth_mod_hash_stream_start(image_id) == 0);
+#else
+	hash_stream = false;
+#endif
+
+	rc = load_image(image_id, image_data, hash_stream);
 	if (rc != 0) {
+		auth_mod_hash_stream_abort();
 		return rc;
 	}
 
@@ -174,6 +262,7 @@ static int load_auth_image_recursive(unsigned int image_id,
 	rc = auth_mod_verify_img(image_id,
 				 (void *)image_data->image_base,
 				 image_data->image_size);
+	auth_mod_hash_stream_abort();
 	if (rc != 0) {
 		/* Authentication error, zero memory and flush it right away. */
 		zero_normalmem((void *)image_data->image_base,
@@ -196,7 +285,7 @@ static int load_auth_image_internal(unsigned int image_id,
 	}
 #endif
 
-	return load_image(image_id, image_data);
+	return load_image(image_id, image_data, false);
 }
 
 /*******************************************************************************
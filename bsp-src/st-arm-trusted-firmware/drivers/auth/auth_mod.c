@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -27,6 +28,16 @@
 
 #pragma weak plat_set_nv_ctr2
 
+/*
+ * Hash of the image being loaded, computed by chunks through
+ * auth_mod_hash_stream_update() and consumed by auth_hash().
+ */
+static struct {
+	const auth_img_desc_t *img_desc;
+	unsigned int len;
+	bool valid;
+} hash_stream;
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -113,6 +124,21 @@ static int auth_hash(const auth_method_param_hash_t *param,
 		return rc;
 	}
 
+	/* Use the hash computed while loading the image if it covers it all */
+	if (hash_stream.img_desc == img_desc) {
+		bool complete = hash_stream.valid && (hash_stream.len == data_len);
+
+		hash_stream.img_desc = NULL;
+		rc = crypto_mod_verify_hash_finish();
+		if (complete) {
+			if (rc != 0) {
+				VERBOSE("[TBB] %s():%d failed with error code %d.\n",
+					__func__, __LINE__, rc);
+			}
+			return rc;
+		}
+	}
+
 	/* Ask the crypto module to verify this hash */
 	rc = crypto_mod_verify_hash(data_ptr, data_len,
 				    hash_der_ptr, hash_der_len);
@@ -125,6 +151,90 @@ static int auth_hash(const auth_method_param_hash_t *param,
 	return 0;
 }
 
+/*
+ * Prepare the hash authentication of a raw image to be computed while it is
+ * loaded, see auth_mod_hash_stream_update().
+ *
+ * Return:
+ *   0 = the image data must be passed to auth_mod_hash_stream_update(),
+ *   Otherwise = the image is hashed by auth_mod_verify_img() as usual
+ */
+int auth_mod_hash_stream_start(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	auth_mod_hash_stream_abort();
+
+	img_desc = FCONF_GET_PROPERTY(tbbr, cot, img_id);
+	if ((img_desc->img_type != IMG_RAW) ||
+	    (img_desc->img_auth_methods == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		if (img_desc->img_auth_methods[i].type == AUTH_METHOD_HASH) {
+			auth_method = &img_desc->img_auth_methods[i];
+			break;
+		}
+	}
+	if (auth_method == NULL) {
+		return 1;
+	}
+
+	/* The parent image has already been authenticated */
+	rc = auth_get_param(auth_method->param.hash.hash, img_desc->parent,
+			    &hash_der_ptr, &hash_der_len);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = crypto_mod_verify_hash_start(hash_der_ptr, hash_der_len);
+	if (rc != 0) {
+		return rc;
+	}
+
+	hash_stream.img_desc = img_desc;
+	hash_stream.len = 0U;
+	hash_stream.valid = true;
+
+	return 0;
+}
+
+/*
+ * Hash the next chunk of the image being loaded. Chunks must be provided in
+ * order. On error, the image is hashed again by auth_mod_verify_img().
+ */
+void auth_mod_hash_stream_update(void *data_ptr, unsigned int data_len)
+{
+	if ((hash_stream.img_desc == NULL) || !hash_stream.valid ||
+	    (data_len == 0U)) {
+		return;
+	}
+
+	if (crypto_mod_verify_hash_update(data_ptr, data_len) != 0) {
+		hash_stream.valid = false;
+		return;
+	}
+
+	hash_stream.len += data_len;
+}
+
+/*
+ * Release the hash computed by chunks if it has not been consumed by
+ * auth_mod_verify_img(), e.g. after a load error.
+ */
+void auth_mod_hash_stream_abort(void)
+{
+	if (hash_stream.img_desc != NULL) {
+		hash_stream.img_desc = NULL;
+		(void)crypto_mod_verify_hash_finish();
+	}
+}
+
 /*
  * Authenticate by digital signature
  *
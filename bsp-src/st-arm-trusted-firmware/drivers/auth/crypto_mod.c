@@ -115,6 +115,60 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start an incremental hash verification
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ *
+ * Returns CRYPTO_ERR_INIT if the library does not support it, in which case
+ * crypto_mod_verify_hash() must be used instead.
+ */
+int crypto_mod_verify_hash_start(void *digest_info_ptr,
+				 unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if ((crypto_lib_desc.verify_hash_start == NULL) ||
+	    (crypto_lib_desc.verify_hash_update == NULL) ||
+	    (crypto_lib_desc.verify_hash_finish == NULL)) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	return crypto_lib_desc.verify_hash_start(digest_info_ptr,
+						 digest_info_len);
+}
+
+/*
+ * Hash more data of an incremental hash verification
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(crypto_lib_desc.verify_hash_update != NULL);
+
+	return crypto_lib_desc.verify_hash_update(data_ptr, data_len);
+}
+
+/*
+ * Complete an incremental hash verification. This must be called once for
+ * each successful crypto_mod_verify_hash_start(), even after an error, to
+ * release the operation.
+ */
+int crypto_mod_verify_hash_finish(void)
+{
+	assert(crypto_lib_desc.verify_hash_finish != NULL);
+
+	return crypto_lib_desc.verify_hash_finish();
+}
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
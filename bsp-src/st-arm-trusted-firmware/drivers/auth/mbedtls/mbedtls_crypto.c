@@ -167,19 +167,19 @@ end2:
 }
 
 /*
- * Match a hash
+ * Parse a digest info
  *
  * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * above. On success, md_info and hash point to the hash algorithm and to the
+ * expected hash value.
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -209,8 +209,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -221,14 +221,36 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
 
 	/* Calculate the hash of the data */
-	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
+	rc = mbedtls_md(md_info, (unsigned char *)data_ptr, data_len,
+			data_hash);
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
@@ -241,6 +263,80 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 
 	return CRYPTO_SUCCESS;
 }
+
+/* Incremental hash verification in progress */
+static mbedtls_md_context_t verify_md_ctx;
+static unsigned char *verify_md_hash;
+static size_t verify_md_len;
+
+/*
+ * Start matching a hash, the data being provided later through
+ * verify_hash_update(). The digest info must remain available until
+ * verify_hash_finish() is called.
+ */
+static int verify_hash_start(void *digest_info_ptr,
+			     unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	assert(verify_md_hash == NULL);
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	mbedtls_md_init(&verify_md_ctx);
+	rc = mbedtls_md_setup(&verify_md_ctx, md_info, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&verify_md_ctx);
+	}
+	if (rc != 0) {
+		mbedtls_md_free(&verify_md_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	verify_md_hash = hash;
+	verify_md_len = mbedtls_md_get_size(md_info);
+
+	return CRYPTO_SUCCESS;
+}
+
+static int verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(verify_md_hash != NULL);
+
+	if (mbedtls_md_update(&verify_md_ctx, (unsigned char *)data_ptr,
+			      data_len) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int verify_hash_finish(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	assert(verify_md_hash != NULL);
+
+	rc = mbedtls_md_finish(&verify_md_ctx, data_hash);
+	if (rc == 0) {
+		rc = memcmp(data_hash, verify_md_hash, verify_md_len);
+	}
+
+	mbedtls_md_free(&verify_md_ctx);
+	verify_md_hash = NULL;
+
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -410,19 +506,27 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
  */
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB_HASH_UPDATE(LIB_NAME, init, verify_signature, verify_hash,
+				calc_hash, auth_decrypt, NULL,
+				verify_hash_start, verify_hash_update,
+				verify_hash_finish);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB_HASH_UPDATE(LIB_NAME, init, verify_signature, verify_hash,
+				calc_hash, NULL, NULL,
+				verify_hash_start, verify_hash_update,
+				verify_hash_finish);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB_HASH_UPDATE(LIB_NAME, init, verify_signature, verify_hash,
+				NULL, auth_decrypt, NULL,
+				verify_hash_start, verify_hash_update,
+				verify_hash_finish);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB_HASH_UPDATE(LIB_NAME, init, verify_signature, verify_hash,
+				NULL, NULL, NULL,
+				verify_hash_start, verify_hash_update,
+				verify_hash_finish);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
 REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, NULL, NULL);
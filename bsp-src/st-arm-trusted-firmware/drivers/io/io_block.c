@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <platform_def.h>
@@ -171,6 +172,21 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
 	return 0;
 }
 
+/*
+ * Check whether @left bytes to read at block offset @skip in the caller
+ * buffer @dst can skip the bounce buffer: the device must accept @dst and
+ * the read must start on a block boundary and span at least one block.
+ */
+static bool block_read_is_direct(const io_block_dev_spec_t *dev_spec,
+				 uintptr_t dst, size_t skip, size_t left)
+{
+	size_t align = dev_spec->direct_read_align;
+
+	return (align != 0U) && (skip == 0U) &&
+	       (left >= dev_spec->block_size) &&
+	       ((dst & (align - 1U)) == 0U);
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -240,6 +256,10 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * When the device supports it (direct_read_align), the whole blocks are
+ * read straight into the caller buffer, in a single request, and only the
+ * unaligned head and tail blocks go through the underlying buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -296,6 +316,26 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if (block_read_is_direct(cur->dev_spec, buffer + count, skip,
+					 left)) {
+			/* Read all whole blocks in the caller buffer */
+			request = left & ~(block_size - 1U);
+			request = ops->read(lba, buffer + count, request);
+			/*
+			 * The read may return size less than
+			 * requested. Round down to the nearest block
+			 * boundary
+			 */
+			nbytes = request & ~(block_size - 1U);
+			if (nbytes == 0U) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -314,6 +354,18 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			request = (request + (block_size - 1U)) &
 				~(block_size - 1U);
 		}
+
+		/*
+		 * Only bounce the unaligned head block if the following
+		 * blocks can then be read directly.
+		 */
+		if ((skip != 0U) && (request > block_size) &&
+		    block_read_is_direct(cur->dev_spec,
+					 buffer + count + block_size - skip,
+					 0U, skip + left - block_size)) {
+			request = block_size;
+		}
+
 		request = ops->read(lba, buf->offset, request);
 
 		if (request <= skip) {
@@ -519,6 +571,8 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	       (is_power_of_2(block_size) != 0U) &&
 	       ((buffer->offset % block_size) == 0U) &&
 	       ((buffer->length % block_size) == 0U));
+	assert((cur->dev_spec->direct_read_align == 0U) ||
+	       (is_power_of_2(cur->dev_spec->direct_read_align) != 0U));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
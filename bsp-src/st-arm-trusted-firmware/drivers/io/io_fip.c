@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -25,6 +26,19 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/* Number of files that can be open at the same time across FIP devices */
+#ifndef MAX_FIP_FILES
+#define MAX_FIP_FILES		2
+#endif
+
+/* Number of ToC entries cached per FIP device */
+#ifndef MAX_FIP_TOC_ENTRIES
+#define MAX_FIP_TOC_ENTRIES	16
+#endif
+
+/* Number of ToC entries read from the backend at once */
+#define FIP_TOC_READ_ENTRIES	4U
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -33,33 +47,48 @@
 		x.node[0], x.node[1], x.node[2], x.node[3],			\
 		x.node[4], x.node[5]
 
+/*
+ * Table of contents of a FIP, as found in the backend device
+ * backend_dev_handle at the location described by the io_block_spec_t
+ * image spec: the cache is keyed on the spec contents, so that a platform
+ * moving the FIP behind the same spec structure gets a new lookup. It is
+ * kept across device close and init so that a FIP is only parsed once.
+ * When the FIP holds more than MAX_FIP_TOC_ENTRIES entries, the remaining
+ * ones are looked up in the backend.
+ */
 typedef struct {
-	unsigned int file_pos;
-	fip_toc_entry_t entry;
-} fip_file_state_t;
+	uintptr_t backend_dev_handle;
+	io_block_spec_t backend_block;
+	uint16_t plat_toc_flag;
+	bool valid;
+	bool complete;
+	unsigned int count;
+	fip_toc_entry_t entries[MAX_FIP_TOC_ENTRIES];
+} fip_toc_cache_t;
 
 /*
- * Maintain dev_spec per FIP Device
- * TODO - Add backend handles and file state
- * per FIP device here once backends like io_memmap
- * can support multiple open files
+ * Maintain dev_spec, backend and ToC per FIP Device. The backend is only
+ * opened for the duration of each FIP operation: backends like io_memmap
+ * allow a single open file and io_block keeps one position per device,
+ * so the FIP cannot hold it open while other images are accessed.
  */
 typedef struct {
 	uintptr_t dev_spec;
 	uint16_t plat_toc_flag;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
+	fip_toc_cache_t *toc;
 } fip_dev_state_t;
 
-/*
- * Only one file can be open across all FIP device
- * as backends like io_memmap don't support
- * multiple open files. The file state and
- * backend handle should be maintained per FIP device
- * if the same support is available in the backend
- */
-static fip_file_state_t current_fip_file = {0};
-static uintptr_t backend_dev_handle;
-static uintptr_t backend_image_spec;
+typedef struct {
+	fip_dev_state_t *dev;
+	unsigned int file_pos;
+	fip_toc_entry_t entry;
+} fip_file_state_t;
+
+static fip_file_state_t file_pool[MAX_FIP_FILES];
 
+static fip_toc_cache_t toc_pool[MAX_FIP_DEVICES];
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
 
@@ -183,8 +212,8 @@ static int free_dev_info(io_dev_info_t *dev_info)
 
 /*
  * Multiple FIP devices can be opened depending on the value of
- * MAX_FIP_DEVICES. Given that there is only one backend, only a
- * single file can be open at a time by any FIP device.
+ * MAX_FIP_DEVICES. Up to MAX_FIP_FILES files can be open at a time across
+ * all FIP devices, sharing the backend handle of their device.
  */
 static int fip_dev_open(const uintptr_t dev_spec,
 			 io_dev_info_t **dev_info)
@@ -212,15 +241,131 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
+/* Return the cached ToC of a backend, or a free one to fill */
+static fip_toc_cache_t *find_toc_cache(const fip_dev_state_t *state)
+{
+	const io_block_spec_t *block =
+		(const io_block_spec_t *)state->backend_image_spec;
+	unsigned int index;
+
+	for (index = 0U; index < (unsigned int)MAX_FIP_DEVICES; ++index) {
+		if (toc_pool[index].valid &&
+		    (toc_pool[index].backend_dev_handle ==
+		     state->backend_dev_handle) &&
+		    (toc_pool[index].backend_block.offset == block->offset) &&
+		    (toc_pool[index].backend_block.length == block->length)) {
+			return &toc_pool[index];
+		}
+	}
+
+	/* Cache slot of the device, same index as its state */
+	index = (unsigned int)(state - state_pool);
+	zeromem(&toc_pool[index], sizeof(fip_toc_cache_t));
+
+	return &toc_pool[index];
+}
+
+/* Read and check the FIP header, then cache the first ToC entries. */
+static int fip_load_toc(fip_dev_state_t *state, uintptr_t backend_handle,
+			fip_toc_cache_t *toc)
+{
+	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	fip_toc_header_t header;
+	size_t bytes_read;
+	unsigned int nb_entries;
+	unsigned int i;
+	int result;
+
+	/* The backend was just opened, at the start of the FIP */
+	result = io_read(backend_handle, (uintptr_t)&header,
+			 sizeof(header), &bytes_read);
+	if (result != 0) {
+		return result;
+	}
+
+	if (!is_valid_header(&header)) {
+		WARN("Firmware Image Package header check failed.\n");
+		return -ENOENT;
+	}
+
+	VERBOSE("FIP header looks OK.\n");
+	/*
+	 * Store 16-bit Platform ToC flags field which occupies
+	 * bits [32-47] in fip header.
+	 */
+	toc->plat_toc_flag = (header.flags >> 32) & 0xffff;
+
+	/* The ToC directly follows the header, read it by chunks */
+	while (!toc->complete && (toc->count < MAX_FIP_TOC_ENTRIES)) {
+		nb_entries = MIN(FIP_TOC_READ_ENTRIES,
+				 MAX_FIP_TOC_ENTRIES - toc->count);
+
+		result = io_read(backend_handle,
+				 (uintptr_t)&toc->entries[toc->count],
+				 nb_entries * sizeof(fip_toc_entry_t),
+				 &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read FIP (%i)\n", result);
+			return result;
+		}
+
+		nb_entries = bytes_read / sizeof(fip_toc_entry_t);
+		if (nb_entries == 0U) {
+			return -EIO;
+		}
+
+		for (i = 0U; i < nb_entries; i++) {
+			if (compare_uuids(&toc->entries[toc->count].uuid,
+					  &uuid_null) == 0) {
+				toc->complete = true;
+				break;
+			}
+			toc->count++;
+		}
+	}
+
+	toc->backend_dev_handle = state->backend_dev_handle;
+	toc->backend_block = *(const io_block_spec_t *)state->backend_image_spec;
+	toc->valid = true;
+
+	VERBOSE("FIP ToC: %u entries cached%s\n", toc->count,
+		toc->complete ? "" : ", more in backend");
+
+	return 0;
+}
+
+/* Forget the files open in the device */
+static void fip_dev_release_files(fip_dev_state_t *state)
+{
+	unsigned int index;
+
+	for (index = 0U; index < (unsigned int)MAX_FIP_FILES; ++index) {
+		if (file_pool[index].dev == state) {
+			zeromem(&file_pool[index], sizeof(fip_file_state_t));
+		}
+	}
+}
+
+/* Forget the backend and the files open in the device */
+static void fip_dev_release_backend(fip_dev_state_t *state)
+{
+	fip_dev_release_files(state);
+
+	state->backend_dev_handle = (uintptr_t)NULL;
+	state->backend_image_spec = (uintptr_t)NULL;
+	state->toc = NULL;
+}
+
 /* Do some basic package checks. */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
 	uintptr_t backend_handle;
-	fip_toc_header_t header;
-	size_t bytes_read;
 	fip_dev_state_t *state;
+	fip_toc_cache_t *toc;
 
 	assert(dev_info != NULL);
 
@@ -236,32 +381,39 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to access image id=%u (%i)\n", image_id, result);
-		result = -ENOENT;
-		goto fip_dev_init_exit;
+	state->backend_dev_handle = backend_dev_handle;
+	state->backend_image_spec = backend_image_spec;
+
+	/* Files open in the device were found in another FIP */
+	toc = find_toc_cache(state);
+	if ((toc != state->toc) || !toc->valid) {
+		fip_dev_release_files(state);
 	}
 
-	result = io_read(backend_handle, (uintptr_t)&header, sizeof(header),
-			&bytes_read);
-	if (result == 0) {
-		if (!is_valid_header(&header)) {
-			WARN("Firmware Image Package header check failed.\n");
+	if (!toc->valid) {
+		/* Attempt to access the FIP image */
+		result = io_open(backend_dev_handle, backend_image_spec,
+				 &backend_handle);
+		if (result != 0) {
+			WARN("Failed to access image id=%u (%i)\n", image_id,
+			     result);
+			fip_dev_release_backend(state);
 			result = -ENOENT;
-		} else {
-			VERBOSE("FIP header looks OK.\n");
-			/*
-			 * Store 16-bit Platform ToC flags field which occupies
-			 * bits [32-47] in fip header.
-			 */
-			state->plat_toc_flag = (header.flags >> 32) & 0xffff;
+			goto fip_dev_init_exit;
+		}
+
+		result = fip_load_toc(state, backend_handle, toc);
+		io_close(backend_handle);
+		if (result != 0) {
+			zeromem(toc, sizeof(fip_toc_cache_t));
+			fip_dev_release_backend(state);
+			result = -ENOENT;
+			goto fip_dev_init_exit;
 		}
 	}
 
-	io_close(backend_handle);
+	state->toc = toc;
+	state->plat_toc_flag = toc->plat_toc_flag;
 
  fip_dev_init_exit:
 	return result;
@@ -270,95 +422,126 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 /* Close a connection to the FIP device */
 static int fip_dev_close(io_dev_info_t *dev_info)
 {
-	/* TODO: Consider tracking open files and cleaning them up here */
+	fip_dev_state_t *state;
+
+	assert(dev_info != NULL);
+
+	state = (fip_dev_state_t *)dev_info->info;
 
-	/* Clear the backend. */
-	backend_dev_handle = (uintptr_t)NULL;
-	backend_image_spec = (uintptr_t)NULL;
+	/* The ToC stays cached for the next init */
+	fip_dev_release_backend(state);
 
 	return free_dev_info(dev_info);
 }
 
 
-/* Open a file for access from package. */
-static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
-			 io_entity_t *entity)
+/* Look for a ToC entry in the part of the ToC which is not cached */
+static int fip_find_uncached_entry(fip_dev_state_t *state, const uuid_t *uuid,
+				   fip_toc_entry_t *entry)
 {
-	int result;
-	uintptr_t backend_handle;
-	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
 	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
+	uintptr_t backend_handle;
 	size_t bytes_read;
-	int found_file = 0;
-
-	assert(uuid_spec != NULL);
-	assert(entity != NULL);
-
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
-	 */
-	if (current_fip_file.entry.offset_address != 0U) {
-		WARN("fip_file_open : Only one open file at a time.\n");
-		return -ENFILE;
-	}
+	int result;
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
+	result = io_open(state->backend_dev_handle, state->backend_image_spec,
 			 &backend_handle);
 	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
+	/* Seek past the FIP header and cached ToC entries */
 	result = io_seek(backend_handle, IO_SEEK_SET,
-			 (signed long long)sizeof(fip_toc_header_t));
+			 (signed long long)(sizeof(fip_toc_header_t) +
+					    (state->toc->count *
+					     sizeof(fip_toc_entry_t))));
 	if (result != 0) {
 		WARN("fip_file_open: failed to seek\n");
 		result = -ENOENT;
-		goto fip_file_open_close;
+		goto fip_find_exit;
 	}
 
-	found_file = 0;
 	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_fip_file.entry,
-				 sizeof(current_fip_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_fip_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-			}
-		} else {
+		result = io_read(backend_handle, (uintptr_t)entry,
+				 sizeof(*entry), &bytes_read);
+		if (result != 0) {
 			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
+			goto fip_find_exit;
+		}
+
+		if (compare_uuids(&entry->uuid, uuid) == 0) {
+			goto fip_find_exit;
+		}
+	} while (compare_uuids(&entry->uuid, &uuid_null) != 0);
+
+	result = -ENOENT;
+
+ fip_find_exit:
+	io_close(backend_handle);
+	return result;
+}
+
+/* Open a file for access from package. */
+static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
+			 io_entity_t *entity)
+{
+	int result = -ENOENT;
+	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
+	fip_dev_state_t *state;
+	fip_file_state_t *fp = NULL;
+	unsigned int index;
+
+	assert(dev_info != NULL);
+	assert(uuid_spec != NULL);
+	assert(entity != NULL);
+
+	state = (fip_dev_state_t *)dev_info->info;
+	if (state->toc == NULL) {
+		WARN("Failed to open Firmware Image Package\n");
+		return -ENOENT;
+	}
+
+	for (index = 0U; index < (unsigned int)MAX_FIP_FILES; ++index) {
+		if (file_pool[index].dev == NULL) {
+			fp = &file_pool[index];
+			break;
+		}
+	}
+
+	if (fp == NULL) {
+		WARN("fip_file_open : Too many open files.\n");
+		return -ENFILE;
+	}
+
+	for (index = 0U; index < state->toc->count; ++index) {
+		if (compare_uuids(&state->toc->entries[index].uuid,
+				  &uuid_spec->uuid) == 0) {
+			fp->entry = state->toc->entries[index];
+			result = 0;
+			break;
 		}
-	} while ((found_file == 0) &&
-			(compare_uuids(&current_fip_file.entry.uuid,
-				&uuid_null) != 0));
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_fip_file.entry' holds
-		 * the base and size of the file.
+	}
+
+	if ((result != 0) && !state->toc->complete) {
+		result = fip_find_uncached_entry(state, &uuid_spec->uuid,
+						 &fp->entry);
+	}
+
+	if (result == 0) {
+		/* All fine. Update entity info with file state and return.
+		 * Set the file position to 0. The 'fp->entry' holds the base
+		 * and size of the file.
 		 */
-		current_fip_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_fip_file;
+		fp->dev = state;
+		fp->file_pos = 0;
+		entity->info = (uintptr_t)fp;
 	} else {
 		/* Did not find the file in the FIP. */
-		current_fip_file.entry.offset_address = 0;
+		zeromem(fp, sizeof(fip_file_state_t));
 		result = -ENOENT;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
-
- fip_file_open_exit:
 	return result;
 }
 
@@ -389,17 +572,20 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
+	fp = (fip_file_state_t *)entity->info;
+	if (fp->dev == NULL) {
+		/* The FIP device was closed under this file */
+		return -ENOENT;
+	}
+
 	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = io_open(fp->dev->backend_dev_handle,
+			 fp->dev->backend_image_spec, &backend_handle);
 	if (result != 0) {
 		WARN("Failed to open FIP (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_exit;
+		return -ENOENT;
 	}
 
-	fp = (fip_file_state_t *)entity->info;
-
 	/* Seek to the position in the FIP where the payload lives */
 	file_offset = fp->entry.offset_address + fp->file_pos;
 	result = io_seek(backend_handle, IO_SEEK_SET,
@@ -407,7 +593,7 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	if (result != 0) {
 		WARN("fip_file_read: failed to seek\n");
 		result = -ENOENT;
-		goto fip_file_read_close;
+		goto fip_file_read_exit;
 	}
 
 	result = io_read(backend_handle, buffer, length, &bytes_read);
@@ -415,18 +601,15 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
 		result = -ENOENT;
-		goto fip_file_read_close;
-	} else {
-		/* Set caller length and new file position. */
-		*length_read = bytes_read;
-		fp->file_pos += bytes_read;
+		goto fip_file_read_exit;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
+	/* Set caller length and new file position. */
+	*length_read = bytes_read;
+	fp->file_pos += bytes_read;
 
  fip_file_read_exit:
+	io_close(backend_handle);
 	return result;
 }
 
@@ -434,11 +617,9 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
-	 * If we had malloc() we would free() here.
-	 */
-	if (current_fip_file.entry.offset_address != 0U) {
-		zeromem(&current_fip_file, sizeof(current_fip_file));
+	/* Release the file state back to the pool */
+	if (entity->info != (uintptr_t)NULL) {
+		zeromem((void *)entity->info, sizeof(fip_file_state_t));
 	}
 
 	/* Clear the Entity info. */
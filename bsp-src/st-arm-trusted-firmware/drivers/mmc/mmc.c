@@ -51,6 +51,11 @@ static bool is_sd_cmd6_enabled(void)
 	return ((mmc_flags & MMC_FLAG_SD_CMD6) != 0U);
 }
 
+static bool is_emmc_hs_enabled(void)
+{
+	return ((mmc_flags & MMC_FLAG_EMMC_HS) != 0U);
+}
+
 static int mmc_send_cmd(unsigned int idx, unsigned int arg,
 			unsigned int r_type, unsigned int *r_data)
 {
@@ -557,6 +562,25 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 		return ret;
 	}
 
+	if (is_emmc_hs_enabled() &&
+	    (mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) &&
+	    (mmc_csd.spec_vers == 4U)) {
+		/* The CSD only advertises the backward compatible speed */
+		if ((mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE] &
+		     MMC_DEVICE_TYPE_HS_52) == 0U) {
+			/* High speed not supported, keep default speed */
+			return 0;
+		}
+
+		ret = mmc_set_ext_csd(CMD_EXTCSD_HS_TIMING, MMC_HS_TIMING_HS);
+		if (ret != 0) {
+			return ret;
+		}
+
+		mmc_dev_info->max_bus_freq = 52000000U;
+		return ops->set_ios(clk, bus_width);
+	}
+
 	if (is_sd_cmd6_enabled() &&
 	    (mmc_dev_info->mmc_dev_type == MMC_IS_SD_HC)) {
 		/* Try to switch to High Speed Mode */
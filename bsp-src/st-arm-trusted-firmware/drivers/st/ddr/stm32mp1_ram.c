@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2018-2023, STMicroelectronics - All Rights Reserved
+ * Copyright (C) 2018-2024, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: GPL-2.0+ OR BSD-3-Clause
  */
@@ -17,6 +17,7 @@
 #include <drivers/st/stm32mp_ddr_test.h>
 #include <drivers/st/stm32mp_ram.h>
 #include <lib/mmio.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
 #include <libfdt.h>
 
 #include <platform_def.h>
@@ -24,6 +25,36 @@
 static struct stm32mp_ddr_priv ddr_priv_data;
 static bool ddr_self_refresh;
 
+#if STM32MP_DDR_TEST_LEVEL != 0
+/*
+ * Run the full array test, with DDR temporarily mapped as cacheable memory
+ * so that the test engine generates line-sized bursts.
+ */
+static void ddr_test_array(size_t size)
+{
+	uintptr_t uret;
+
+	if (stm32mp_unmap_ddr() != 0) {
+		panic();
+	}
+
+	if (mmap_add_dynamic_region(STM32MP_DDR_BASE, STM32MP_DDR_BASE, STM32MP_DDR_MAX_SIZE,
+				    MT_MEMORY | MT_RW | MT_SECURE) != 0) {
+		panic();
+	}
+
+	uret = stm32mp_ddr_test_array(STM32MP_DDR_BASE, size, STM32MP_DDR_TEST_LEVEL);
+	if (uret != 0UL) {
+		ERROR("DDR array test: error @ 0x%lx\n", uret);
+		panic();
+	}
+
+	if ((stm32mp_unmap_ddr() != 0) || (stm32mp_map_ddr_non_cacheable() != 0)) {
+		panic();
+	}
+}
+#endif /* STM32MP_DDR_TEST_LEVEL != 0 */
+
 int stm32mp1_ddr_clk_enable(struct stm32mp_ddr_priv *priv, uint32_t mem_speed)
 {
 	unsigned long ddrphy_clk, ddr_clk, mem_speed_hz;
@@ -149,6 +180,10 @@ static int stm32mp1_ddr_setup(void)
 		}
 
 		INFO("Memory size = 0x%zx (%zu MB)\n", retsize, retsize / (1024U * 1024U));
+
+#if STM32MP_DDR_TEST_LEVEL != 0
+		ddr_test_array(config.info.size);
+#endif
 	}
 
 	/*
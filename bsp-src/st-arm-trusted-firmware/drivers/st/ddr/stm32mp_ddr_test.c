@@ -4,9 +4,13 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
+
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <drivers/st/stm32mp_ddr_test.h>
 #include <lib/mmio.h>
+#include <lib/utils.h>
 
 #include <platform_def.h>
 
@@ -18,6 +22,9 @@
 #define DDR_ANTIPATTERN	0x55555555U
 #endif /* __aarch64__ */
 
+#define DDR_TEST_WORD_BITS	(sizeof(u_register_t) * 8U)
+#define DDR_TEST_LINE_WORDS	(CACHE_WRITEBACK_GRANULE / sizeof(u_register_t))
+
 static void mmio_write_pattern(uintptr_t addr, u_register_t value)
 {
 #ifdef __aarch64__
@@ -161,3 +168,197 @@ size_t stm32mp_ddr_check_size(void)
 
 	return offset;
 }
+
+/*
+ * Full array test engine.
+ * The memory is expected to be mapped as normal cacheable memory: each pass
+ * accesses a whole cache line per iteration, so that the traffic reaching the
+ * DDR is made of line-sized bursts. The data cache is cleaned and invalidated
+ * between a write pass and the following read pass, so that the read values
+ * come from the DDR and not from the cache.
+ */
+static void ddr_test_sync(uintptr_t base, size_t size)
+{
+	flush_dcache_range(base, size);
+}
+
+static uintptr_t ddr_test_error(const u_register_t *addr, u_register_t expected)
+{
+	VERBOSE("DDR test: @ 0x%lx expected 0x%lx read 0x%lx\n",
+		(uintptr_t)addr, (unsigned long)expected, (unsigned long)*addr);
+
+	return (uintptr_t)addr;
+}
+
+/*
+ * Address-in-address: each word holds its own address, optionally inverted.
+ * Detects address decoding faults over the whole array.
+ */
+static uintptr_t ddr_test_addr_in_addr(uintptr_t base, size_t size, u_register_t inv)
+{
+	u_register_t *end = (u_register_t *)(base + size);
+	u_register_t *line;
+	unsigned int i;
+
+	for (line = (u_register_t *)base; line < end; line += DDR_TEST_LINE_WORDS) {
+		for (i = 0U; i < DDR_TEST_LINE_WORDS; i++) {
+			line[i] = (u_register_t)&line[i] ^ inv;
+		}
+	}
+
+	ddr_test_sync(base, size);
+
+	for (line = (u_register_t *)base; line < end; line += DDR_TEST_LINE_WORDS) {
+		for (i = 0U; i < DDR_TEST_LINE_WORDS; i++) {
+			if (line[i] != ((u_register_t)&line[i] ^ inv)) {
+				return ddr_test_error(&line[i], (u_register_t)&line[i] ^ inv);
+			}
+		}
+	}
+
+	return 0UL;
+}
+
+/*
+ * Walking ones (or zeros if inverted): the single set bit moves by one
+ * position at each word, so every data line is toggled within each burst.
+ */
+static u_register_t ddr_test_walk(u_register_t pattern)
+{
+	return (pattern << 1) | (pattern >> (DDR_TEST_WORD_BITS - 1U));
+}
+
+static uintptr_t ddr_test_walking_ones(uintptr_t base, size_t size, u_register_t inv)
+{
+	u_register_t *end = (u_register_t *)(base + size);
+	u_register_t *line;
+	u_register_t pattern = 1U;
+	unsigned int i;
+
+	for (line = (u_register_t *)base; line < end; line += DDR_TEST_LINE_WORDS) {
+		for (i = 0U; i < DDR_TEST_LINE_WORDS; i++) {
+			line[i] = pattern ^ inv;
+			pattern = ddr_test_walk(pattern);
+		}
+	}
+
+	ddr_test_sync(base, size);
+
+	pattern = 1U;
+	for (line = (u_register_t *)base; line < end; line += DDR_TEST_LINE_WORDS) {
+		for (i = 0U; i < DDR_TEST_LINE_WORDS; i++) {
+			if (line[i] != (pattern ^ inv)) {
+				return ddr_test_error(&line[i], pattern ^ inv);
+			}
+			pattern = ddr_test_walk(pattern);
+		}
+	}
+
+	return 0UL;
+}
+
+/*
+ * Moving inversions: fill with zeros, then for each word in ascending order
+ * check zeros and write ones, then in descending order check ones and write
+ * zeros, and finally check zeros. Detects coupling faults between cells.
+ */
+static uintptr_t ddr_test_moving_inv(uintptr_t base, size_t size)
+{
+	u_register_t *start = (u_register_t *)base;
+	u_register_t *end = (u_register_t *)(base + size);
+	u_register_t *line;
+	size_t n;
+	unsigned int i;
+
+	zero_normalmem((void *)base, size);
+
+	ddr_test_sync(base, size);
+
+	for (line = start; line < end; line += DDR_TEST_LINE_WORDS) {
+		for (i = 0U; i < DDR_TEST_LINE_WORDS; i++) {
+			if (line[i] != 0U) {
+				return ddr_test_error(&line[i], 0U);
+			}
+			line[i] = ~(u_register_t)0U;
+		}
+	}
+
+	ddr_test_sync(base, size);
+
+	for (n = size / CACHE_WRITEBACK_GRANULE; n > 0U; n--) {
+		line = start + ((n - 1U) * DDR_TEST_LINE_WORDS);
+
+		for (i = DDR_TEST_LINE_WORDS; i > 0U; i--) {
+			if (line[i - 1U] != ~(u_register_t)0U) {
+				return ddr_test_error(&line[i - 1U], ~(u_register_t)0U);
+			}
+			line[i - 1U] = 0U;
+		}
+	}
+
+	ddr_test_sync(base, size);
+
+	for (line = start; line < end; line += DDR_TEST_LINE_WORDS) {
+		for (i = 0U; i < DDR_TEST_LINE_WORDS; i++) {
+			if (line[i] != 0U) {
+				return ddr_test_error(&line[i], 0U);
+			}
+		}
+	}
+
+	return 0UL;
+}
+
+/*******************************************************************************
+ * This function tests the whole DDR array with the tests selected by level,
+ * see STM32MP_DDR_TEST_* definitions. It has to be run with Data Cache on and
+ * the area mapped as cacheable memory. The DDR content is lost. It relies on
+ * data cache maintenance and on the generic timer, so it only runs on target.
+ * base: start address of the area, aligned on a cache line.
+ * size: size in bytes of the area, multiple of a cache line.
+ * Returns 0 if success, and first failing address else.
+ ******************************************************************************/
+uintptr_t stm32mp_ddr_test_array(uintptr_t base, size_t size, unsigned int level)
+{
+	unsigned long long start = read_cntpct_el0();
+	unsigned long long ms;
+	unsigned long long bytes = 0ULL;
+	uintptr_t ret = 0UL;
+
+	assert((base % CACHE_WRITEBACK_GRANULE) == 0U);
+	assert((size % CACHE_WRITEBACK_GRANULE) == 0U);
+
+	if (level >= STM32MP_DDR_TEST_ADDR_IN_ADDR) {
+		ret = ddr_test_addr_in_addr(base, size, 0U);
+		if (ret == 0UL) {
+			ret = ddr_test_addr_in_addr(base, size, ~(u_register_t)0U);
+		}
+		bytes += 4ULL * size;
+	}
+
+	if ((ret == 0UL) && (level >= STM32MP_DDR_TEST_WALKING_ONES)) {
+		ret = ddr_test_walking_ones(base, size, 0U);
+		if (ret == 0UL) {
+			ret = ddr_test_walking_ones(base, size, ~(u_register_t)0U);
+		}
+		bytes += 4ULL * size;
+	}
+
+	if ((ret == 0UL) && (level >= STM32MP_DDR_TEST_MOVING_INV)) {
+		ret = ddr_test_moving_inv(base, size);
+		bytes += 6ULL * size;
+	}
+
+	/* Do not leave lines of the tested area in the cache */
+	ddr_test_sync(base, size);
+
+	if (ret != 0UL) {
+		return ret;
+	}
+
+	ms = ((read_cntpct_el0() - start) * 1000ULL) / read_cntfrq_el0();
+	INFO("DDR test level %u: %llu MB in %llu ms (%llu MB/s)\n", level,
+	     bytes >> 20, ms, (ms != 0ULL) ? (((bytes >> 20) * 1000ULL) / ms) : 0ULL);
+
+	return 0UL;
+}
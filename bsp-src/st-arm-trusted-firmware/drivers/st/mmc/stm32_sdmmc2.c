@@ -162,6 +162,9 @@ static struct stm32_sdmmc2_params sdmmc2_params;
 
 static bool next_cmd_is_acmd;
 
+/* Block length last set with CMD16, 0 if unknown */
+static uint32_t block_len;
+
 #pragma weak plat_sdmmc2_use_dma
 bool plat_sdmmc2_use_dma(unsigned int instance, unsigned int memory)
 {
@@ -179,6 +182,8 @@ static void stm32_sdmmc2_init(void)
 		freq = MIN(sdmmc2_params.max_freq, freq);
 	}
 
+	block_len = 0U;
+
 	if (sdmmc2_params.vmmc_regu != NULL) {
 		ret = regulator_disable(sdmmc2_params.vmmc_regu);
 		if (ret < 0) {
@@ -295,14 +300,8 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 		break;
 	case MMC_CMD(17):
 	case MMC_CMD(18):
+		/* End of data transfer is handled in stm32_sdmmc2_read() */
 		cmd_reg |= SDMMC_CMDR_CMDTRANS;
-		if (sdmmc2_params.use_dma) {
-			flags_data |= SDMMC_STAR_DCRCFAIL |
-				      SDMMC_STAR_DTIMEOUT |
-				      SDMMC_STAR_DATAEND |
-				      SDMMC_STAR_RXOVERR |
-				      SDMMC_STAR_IDMATE;
-		}
 		break;
 	case MMC_ACMD(41):
 		arg_reg |= OCR_3_2_3_3 | OCR_3_3_3_4;
@@ -328,10 +327,11 @@ static int stm32_sdmmc2_send_cmd_req(struct mmc_cmd *cmd)
 
 	/*
 	 * Clear the SDMMC_DCTRLR if the command does not await data.
-	 * Skip CMD55 as the next command could be data related, and
-	 * the register could have been set in prepare function.
+	 * Skip CMD55 and CMD23 as the next command could be data related,
+	 * and the register could have been set in prepare function.
 	 */
-	if (((cmd_reg & SDMMC_CMDR_CMDTRANS) == 0U) && !next_cmd_is_acmd) {
+	if (((cmd_reg & SDMMC_CMDR_CMDTRANS) == 0U) && !next_cmd_is_acmd &&
+	    (cmd->cmd_idx != MMC_CMD(23))) {
 		mmio_write_32(base + SDMMC_DCTRLR, 0U);
 	}
 
@@ -552,23 +552,28 @@ static int stm32_sdmmc2_prepare(int lba, uintptr_t buf, size_t size)
 		inv_dcache_range(buf, size);
 	}
 
-	/* Prepare CMD 16*/
-	mmio_write_32(base + SDMMC_DTIMER, 0);
+	/* Prepare CMD 16, unless the card already uses this block length */
+	if (arg_size != block_len) {
+		mmio_write_32(base + SDMMC_DTIMER, 0);
 
-	mmio_write_32(base + SDMMC_DLENR, 0);
+		mmio_write_32(base + SDMMC_DLENR, 0);
 
-	mmio_write_32(base + SDMMC_DCTRLR, 0);
+		mmio_write_32(base + SDMMC_DCTRLR, 0);
 
-	zeromem(&cmd, sizeof(struct mmc_cmd));
+		zeromem(&cmd, sizeof(struct mmc_cmd));
 
-	cmd.cmd_idx = MMC_CMD(16);
-	cmd.cmd_arg = arg_size;
-	cmd.resp_type = MMC_RESPONSE_R1;
+		cmd.cmd_idx = MMC_CMD(16);
+		cmd.cmd_arg = arg_size;
+		cmd.resp_type = MMC_RESPONSE_R1;
 
-	ret = stm32_sdmmc2_send_cmd(&cmd);
-	if (ret != 0) {
-		ERROR("CMD16 failed\n");
-		return ret;
+		ret = stm32_sdmmc2_send_cmd(&cmd);
+		if (ret != 0) {
+			ERROR("CMD16 failed\n");
+			block_len = 0U;
+			return ret;
+		}
+
+		block_len = arg_size;
 	}
 
 	/* Prepare data command */
@@ -593,6 +598,69 @@ static int stm32_sdmmc2_prepare(int lba, uintptr_t buf, size_t size)
 	return 0;
 }
 
+static int stm32_sdmmc2_read_error(uint32_t status)
+{
+	uintptr_t base = sdmmc2_params.reg_base;
+	int ret;
+
+	ERROR("%s: Read error (status = %x)\n", __func__, status);
+	mmio_write_32(base + SDMMC_DCTRLR, SDMMC_DCTRLR_FIFORST);
+
+	mmio_write_32(base + SDMMC_ICR, SDMMC_STATIC_FLAGS);
+
+	ret = stm32_sdmmc2_stop_transfer();
+	if (ret != 0) {
+		return ret;
+	}
+
+	return -EIO;
+}
+
+static int stm32_sdmmc2_dma_read(uintptr_t buf, size_t size)
+{
+	uint32_t error_flags = SDMMC_STAR_RXOVERR | SDMMC_STAR_DCRCFAIL |
+			       SDMMC_STAR_DTIMEOUT | SDMMC_STAR_IDMATE;
+	uint32_t status;
+	uintptr_t base = sdmmc2_params.reg_base;
+	uint64_t timeout;
+	int ret;
+
+	/*
+	 * The IDMA transfers the whole request in the background, only wait
+	 * for its end, with the same timeout as a polled transfer.
+	 */
+	timeout = timeout_init_us(TIMEOUT_US_1_S);
+
+	do {
+		status = mmio_read_32(base + SDMMC_STAR);
+
+		if ((status & error_flags) != 0U) {
+			return stm32_sdmmc2_read_error(status);
+		}
+
+		if (timeout_elapsed(timeout)) {
+			ERROR("%s: timeout 1s (status = %x)\n",
+			      __func__, status);
+			mmio_write_32(base + SDMMC_ICR,
+				      SDMMC_STATIC_FLAGS);
+
+			ret = stm32_sdmmc2_stop_transfer();
+			if (ret != 0) {
+				return ret;
+			}
+
+			return -ETIMEDOUT;
+		}
+	} while ((status & SDMMC_STAR_DATAEND) == 0U);
+
+	mmio_write_32(base + SDMMC_ICR, SDMMC_STATIC_FLAGS);
+	mmio_clrbits_32(base + SDMMC_CMDR, SDMMC_CMDR_CMDTRANS);
+
+	inv_dcache_range(buf, size);
+
+	return 0;
+}
+
 static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size)
 {
 	uint32_t error_flags = SDMMC_STAR_RXOVERR | SDMMC_STAR_DCRCFAIL |
@@ -611,9 +679,7 @@ static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size)
 	buffer = (uint32_t *)buf;
 
 	if (sdmmc2_params.use_dma) {
-		inv_dcache_range(buf, size);
-
-		return 0;
+		return stm32_sdmmc2_dma_read(buf, size);
 	}
 
 	if (size <= MMC_BLOCK_SIZE) {
@@ -626,20 +692,7 @@ static int stm32_sdmmc2_read(int lba, uintptr_t buf, size_t size)
 		status = mmio_read_32(base + SDMMC_STAR);
 
 		if ((status & error_flags) != 0U) {
-			ERROR("%s: Read error (status = %x)\n", __func__,
-			      status);
-			mmio_write_32(base + SDMMC_DCTRLR,
-				      SDMMC_DCTRLR_FIFORST);
-
-			mmio_write_32(base + SDMMC_ICR,
-				      SDMMC_STATIC_FLAGS);
-
-			ret = stm32_sdmmc2_stop_transfer();
-			if (ret != 0) {
-				return ret;
-			}
-
-			return -EIO;
+			return stm32_sdmmc2_read_error(status);
 		}
 
 		if (timeout_elapsed(timeout)) {
@@ -54,6 +54,9 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_hash_stream_start(unsigned int img_id);
+void auth_mod_hash_stream_update(void *data_ptr, unsigned int data_len);
+void auth_mod_hash_stream_abort(void);
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
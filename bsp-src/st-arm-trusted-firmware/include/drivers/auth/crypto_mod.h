@@ -61,6 +61,18 @@ typedef struct crypto_lib_desc_s {
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
 
+	/*
+	 * Verify a hash incrementally (optional). verify_hash_start() parses
+	 * the expected digest, verify_hash_update() hashes the data as it
+	 * becomes available and verify_hash_finish() compares the digests and
+	 * releases the operation. Only one operation can be in progress.
+	 * Return one of the 'enum crypto_ret_value' options.
+	 */
+	int (*verify_hash_start)(void *digest_info_ptr,
+				 unsigned int digest_info_len);
+	int (*verify_hash_update)(void *data_ptr, unsigned int data_len);
+	int (*verify_hash_finish)(void);
+
 	/* Calculate a hash. Return hash value */
 	int (*calc_hash)(enum crypto_md_algo md_alg, void *data_ptr,
 			 unsigned int data_len,
@@ -98,6 +110,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_verify_hash_start(void *digest_info_ptr,
+				 unsigned int digest_info_len);
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_verify_hash_finish(void);
 #endif /* (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY) || \
 	  (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC) */
 
@@ -131,6 +147,29 @@ int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 		.convert_pk = _convert_pk \
 	}
 
+/*
+ * Macro to register a cryptographic library that also supports incremental
+ * hash verification
+ */
+#define REGISTER_CRYPTO_LIB_HASH_UPDATE(_name, _init, _verify_signature, \
+					_verify_hash, _calc_hash, \
+					_auth_decrypt, _convert_pk, \
+					_verify_hash_start, \
+					_verify_hash_update, \
+					_verify_hash_finish) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.verify_hash_start = _verify_hash_start, \
+		.verify_hash_update = _verify_hash_update, \
+		.verify_hash_finish = _verify_hash_finish, \
+		.calc_hash = _calc_hash, \
+		.auth_decrypt = _auth_decrypt, \
+		.convert_pk = _convert_pk \
+	}
+
 extern const crypto_lib_desc_t crypto_lib_desc;
 
 #endif /* CRYPTO_MOD_H */
@@ -19,6 +19,12 @@ typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Alignment (power of 2) of a destination address the read operation
+	 * accepts, when whole blocks can be read directly in the caller
+	 * buffer. 0 means all reads go through the buffer above.
+	 */
+	size_t		direct_read_align;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
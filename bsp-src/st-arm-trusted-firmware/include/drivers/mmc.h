@@ -60,6 +60,7 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
 #define CMD_EXTCSD_PART_SWITCH_TIME	199
 #define CMD_EXTCSD_SEC_CNT		212
 #define CMD_EXTCSD_BOOT_SIZE_MULT	226
@@ -82,6 +83,8 @@
 #define MMC_BOOT_MODE_BACKWARD		(U(0) << 3)
 #define MMC_BOOT_MODE_HS_TIMING		(U(1) << 3)
 #define MMC_BOOT_MODE_DDR		(U(2) << 3)
+#define MMC_HS_TIMING_HS		U(1)
+#define MMC_DEVICE_TYPE_HS_52		BIT(1)
 
 #define EXTCSD_SET_CMD			(U(0) << 24)
 #define EXTCSD_SET_BITS			(U(1) << 24)
@@ -113,6 +116,7 @@
 
 #define MMC_FLAG_CMD23			(U(1) << 0)
 #define MMC_FLAG_SD_CMD6		(U(1) << 1)
+#define MMC_FLAG_EMMC_HS		(U(1) << 2)
 
 #define CMD8_CHECK_PATTERN		U(0xAA)
 #define VHS_2_7_3_6_V			BIT(8)
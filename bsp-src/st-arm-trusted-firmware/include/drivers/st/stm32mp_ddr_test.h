@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2022-2023, STMicroelectronics - All Rights Reserved
+ * Copyright (C) 2022-2024, STMicroelectronics - All Rights Reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,11 +7,23 @@
 #ifndef STM32MP_DDR_TEST_H
 #define STM32MP_DDR_TEST_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <lib/utils_def.h>
+
+/*
+ * Coverage levels of stm32mp_ddr_test_array(), each level also runs the
+ * tests of the lower ones.
+ */
+#define STM32MP_DDR_TEST_ADDR_IN_ADDR	U(1)
+#define STM32MP_DDR_TEST_WALKING_ONES	U(2)
+#define STM32MP_DDR_TEST_MOVING_INV	U(3)
+
 uintptr_t stm32mp_ddr_test_rw_access(void);
 uintptr_t stm32mp_ddr_test_data_bus(void);
 uintptr_t stm32mp_ddr_test_addr_bus(size_t size);
 size_t stm32mp_ddr_check_size(void);
+uintptr_t stm32mp_ddr_test_array(uintptr_t base, size_t size, unsigned int level);
 
 #endif /* STM32MP_DDR_TEST_H */
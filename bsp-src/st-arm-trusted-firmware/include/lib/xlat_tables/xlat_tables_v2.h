@@ -275,6 +275,14 @@ void mmap_add_region_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm);
 void mmap_add(const mmap_region_t *mm);
 void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm);
 
+/*
+ * Same as mmap_add(), but the regions are inserted and sorted at once, and
+ * static regions that are contiguous in VA and PA with the same attributes
+ * and granularity are merged so they can be mapped with larger blocks.
+ */
+void mmap_add_bulk(const mmap_region_t *mm);
+void mmap_add_bulk_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm);
+
 /*
  * Add a region with defined base PA. Returns base VA calculated using the
  * highest existing region in the mmap array even if it fails to allocate the
@@ -41,6 +41,11 @@ void mmap_add(const mmap_region_t *mm)
 	mmap_add_ctx(&tf_xlat_ctx, mm);
 }
 
+void mmap_add_bulk(const mmap_region_t *mm)
+{
+	mmap_add_bulk_ctx(&tf_xlat_ctx, mm);
+}
+
 void mmap_add_region_alloc_va(unsigned long long base_pa, uintptr_t *base_va,
 			      size_t size, unsigned int attr)
 {
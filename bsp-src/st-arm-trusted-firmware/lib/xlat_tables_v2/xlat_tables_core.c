@@ -101,6 +101,23 @@ static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+/* Returns the number of sub-tables currently in use. */
+int xlat_tables_used_count(const xlat_ctx_t *ctx)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	int used = 0;
+
+	for (int i = 0; i < ctx->tables_num; ++i) {
+		if (ctx->tables_mapped_regions[i] != 0)
+			++used;
+	}
+
+	return used;
+#else
+	return ctx->next_table;
+#endif
+}
+
 /*
  * Returns a block/page table descriptor for the given level and attributes.
  */
@@ -947,6 +964,139 @@ void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 	}
 }
 
+/*
+ * Returns true if region a must be placed before region b in the mmap array,
+ * i.e. lower region VA end first, then smaller region size first. See
+ * mmap_add_region_ctx().
+ */
+static bool mmap_region_is_before(const mmap_region_t *a,
+				  const mmap_region_t *b)
+{
+	uintptr_t end_va_a = a->base_va + a->size - 1U;
+	uintptr_t end_va_b = b->base_va + b->size - 1U;
+
+	if (end_va_a != end_va_b)
+		return end_va_a < end_va_b;
+
+	return a->size < b->size;
+}
+
+/*
+ * Two static regions can be merged if they are contiguous in both VA and PA
+ * and are mapped with the same attributes and granularity.
+ */
+static bool mmap_regions_can_merge(const mmap_region_t *a,
+				   const mmap_region_t *b)
+{
+#if PLAT_XLAT_TABLES_DYNAMIC
+	if (((a->attr & MT_DYNAMIC) != 0U) || ((b->attr & MT_DYNAMIC) != 0U))
+		return false;
+#endif
+
+	return ((a->base_va + a->size) == b->base_va) &&
+	       ((a->base_pa + a->size) == b->base_pa) &&
+	       (a->attr == b->attr) && (a->granularity == b->granularity);
+}
+
+/*
+ * Returns true if a region of the array other than mmap[i] and mmap[j]
+ * overlaps the VA range covered by the two of them. Entries between i and j
+ * have already been moved down while merging and are not looked at.
+ */
+static bool mmap_merge_overlaps(const mmap_region_t *mmap, unsigned int num,
+				unsigned int i, unsigned int j)
+{
+	uintptr_t base_va = mmap[i].base_va;
+	uintptr_t end_va = mmap[j].base_va + mmap[j].size - 1U;
+	unsigned int k;
+
+	for (k = 0U; k < num; k++) {
+		if ((k >= i) && (k <= j))
+			continue;
+
+		if ((mmap[k].base_va <= end_va) &&
+		    ((mmap[k].base_va + mmap[k].size - 1U) >= base_va))
+			return true;
+	}
+
+	return false;
+}
+
+void mmap_add_bulk_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
+{
+	mmap_region_t *mmap = ctx->mmap;
+	unsigned int num = 0U, i, j;
+	int ret;
+
+	/* Static regions must be added before initializing the xlat tables. */
+	assert(!ctx->initialized);
+
+	while ((num < ctx->mmap_num) && (mmap[num].size != 0U))
+		num++;
+
+	/*
+	 * Append all the new regions. Each one is checked against the regions
+	 * already in the array, including the ones appended before it.
+	 */
+	for (; mm->granularity != 0U; mm++) {
+		/* Ignore empty regions */
+		if (mm->size == 0U)
+			continue;
+
+		ret = mmap_add_region_check(ctx, mm);
+		if (ret != 0) {
+			ERROR("mmap_add_region_check() failed. error %d\n", ret);
+			assert(false);
+			break;
+		}
+
+		mmap[num++] = *mm;
+
+		if ((mm->base_pa + mm->size - 1U) > ctx->max_pa)
+			ctx->max_pa = mm->base_pa + mm->size - 1U;
+		if ((mm->base_va + mm->size - 1U) > ctx->max_va)
+			ctx->max_va = mm->base_va + mm->size - 1U;
+	}
+
+	/*
+	 * Sort the whole array once, the order is the one kept by
+	 * mmap_add_region_ctx(). The array is short and mostly sorted already,
+	 * an insertion sort is enough.
+	 */
+	for (i = 1U; i < num; i++) {
+		mmap_region_t tmp = mmap[i];
+
+		j = i;
+		while ((j > 0U) && mmap_region_is_before(&tmp, &mmap[j - 1U])) {
+			mmap[j] = mmap[j - 1U];
+			j--;
+		}
+		mmap[j] = tmp;
+	}
+
+	/*
+	 * Merge neighbour regions that describe one contiguous mapping so that
+	 * it can be mapped with the largest blocks its alignment allows instead
+	 * of being split at the boundaries of the original regions. Regions
+	 * are only merged when no other region overlaps the merged range, so
+	 * that it can't partially overlap a region that was nested in one of
+	 * the two, and so that it keeps its place in the sort order.
+	 */
+	if (num != 0U) {
+		for (i = 0U, j = 1U; j < num; j++) {
+			if (mmap_regions_can_merge(&mmap[i], &mmap[j]) &&
+			    !mmap_merge_overlaps(mmap, num, i, j)) {
+				mmap[i].size += mmap[j].size;
+			} else {
+				mmap[++i] = mmap[j];
+			}
+		}
+
+		for (j = i + 1U; j < num; j++)
+			(void)memset(&mmap[j], 0, sizeof(mmap[j]));
+	}
+}
+
 #if PLAT_XLAT_TABLES_DYNAMIC
 
 int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
@@ -1195,6 +1345,9 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	assert(!is_mmu_enabled_ctx(ctx));
 
 	mmap_region_t *mm = ctx->mmap;
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	uint64_t start_cnt = read_cntpct_el0();
+#endif
 
 	assert(ctx->va_max_address >=
 		(xlat_get_min_virt_addr_space_size() - 1U));
@@ -1240,5 +1393,14 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 
 	ctx->initialized = true;
 
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+	if (read_cntfrq_el0() != 0U) {
+		VERBOSE("Translation tables set up in %llu us, %d/%d sub-tables used\n",
+			((read_cntpct_el0() - start_cnt) * 1000000ULL) /
+			read_cntfrq_el0(),
+			xlat_tables_used_count(ctx), ctx->tables_num);
+	}
+#endif
+
 	xlat_tables_print(ctx);
 }
@@ -77,6 +77,9 @@ void xlat_mmap_print(const mmap_region_t *mmap);
  */
 void xlat_tables_print(xlat_ctx_t *ctx);
 
+/* Returns the number of sub-tables of a context currently in use. */
+int xlat_tables_used_count(const xlat_ctx_t *ctx);
+
 /*
  * Returns a block/page table descriptor for the given level and attributes.
  */
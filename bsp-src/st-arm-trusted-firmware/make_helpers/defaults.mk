@@ -173,6 +173,10 @@ ifeq ($(KEY_ALG),rsa)
 KEY_SIZE			:= 2048
 endif
 
+# Size of the chunks used to load and hash raw images at the same time, 0 means
+# images are read at once and hashed during authentication
+LOAD_IMAGE_HASH_CHUNK_SIZE	:= 0
+
 # Option to build TF with Measured Boot support
 MEASURED_BOOT			:= 0
 
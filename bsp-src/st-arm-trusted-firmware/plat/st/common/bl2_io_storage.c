@@ -46,6 +46,7 @@
 
 #include <platform_def.h>
 #include <stm32cubeprogrammer.h>
+#include <stm32mp_boot_stats.h>
 #include <stm32mp_efi.h>
 #include <stm32mp_fconf_getter.h>
 #include <stm32mp_io_storage.h>
@@ -79,6 +80,13 @@ static io_block_dev_spec_t mmc_block_dev_spec = {
 		.write = NULL,
 	},
 	.block_size = MMC_BLOCK_SIZE,
+	/*
+	 * Images are read through their own load area, set as buffer in
+	 * plat_get_image_source(), and moved down in place when they do not
+	 * start on a block boundary. Direct reads put the whole blocks at
+	 * their final address. SDMMC FIFO accesses are 32-bit wide.
+	 */
+	.direct_read_align = sizeof(uint32_t),
 };
 
 static const io_dev_connector_t *mmc_dev_con;
@@ -278,6 +286,8 @@ static void boot_mmc(enum mmc_device_type mmc_dev_type,
 
 	if (mmc_dev_type != MMC_IS_EMMC) {
 		params.flags = MMC_FLAG_SD_CMD6;
+	} else {
+		params.flags = MMC_FLAG_CMD23 | MMC_FLAG_EMMC_HS;
 	}
 
 	params.device_info = &mmc_info;
@@ -553,6 +563,8 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 	static bool gpt_init_done __maybe_unused;
 	uint16_t boot_itf = stm32mp_get_boot_itf_selected();
 
+	stm32mp_boot_stats_image_start(image_id);
+
 	if (stm32mp_skip_boot_device_after_standby()) {
 		return 0;
 	}
@@ -6,10 +6,14 @@
 
 RESET_TO_BL2			:=	1
 
+STM32MP_BOOT_STATS		?=	0
 STM32MP_EARLY_CONSOLE		?=	0
 STM32MP_RECONFIGURE_CONSOLE	?=	0
 STM32MP_UART_BAUDRATE		?=	115200
 
+# Full DDR array test coverage level at cold boot (0: disabled)
+STM32MP_DDR_TEST_LEVEL		?=	0
+
 # Add specific ST version
 ST_VERSION 			:=	r1.0
 ST_GIT_SHA1			:=	$(shell git rev-parse --short=8 HEAD 2>/dev/null)
@@ -118,6 +122,7 @@ endif
 $(eval $(call assert_booleans,\
 	$(sort \
 		PLAT_XLAT_TABLES_DYNAMIC \
+		STM32MP_BOOT_STATS \
 		STM32MP_EARLY_CONSOLE \
 		STM32MP_EMMC \
 		STM32MP_EMMC_BOOT \
@@ -134,6 +139,7 @@ $(eval $(call assert_booleans,\
 $(eval $(call assert_numerics,\
 	$(sort \
 		STM32_TF_VERSION \
+		STM32MP_DDR_TEST_LEVEL \
 		STM32MP_UART_BAUDRATE \
 )))
 
@@ -141,6 +147,8 @@ $(eval $(call add_defines,\
 	$(sort \
 		PLAT_XLAT_TABLES_DYNAMIC \
 		STM32_TF_VERSION \
+		STM32MP_BOOT_STATS \
+		STM32MP_DDR_TEST_LEVEL \
 		STM32MP_EARLY_CONSOLE \
 		STM32MP_EMMC \
 		STM32MP_EMMC_BOOT \
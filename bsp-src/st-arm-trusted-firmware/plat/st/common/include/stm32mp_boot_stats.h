@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STM32MP_BOOT_STATS_H
+#define STM32MP_BOOT_STATS_H
+
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/* BL2 phases measured between a start and an end capture point */
+#define STM32MP_BOOT_PHASE_CLK		U(0)
+#define STM32MP_BOOT_PHASE_DDR		U(1)
+#define STM32MP_BOOT_PHASE_NB		U(2)
+
+/* PMF service used for the phase capture points when ENABLE_PMF=1 */
+#define STM32MP_PMF_BOOT_SVC_ID		U(0x20)
+#define STM32MP_BOOT_TS_NB		(STM32MP_BOOT_PHASE_NB * 2U)
+
+/* Vendor specific transfer list tag carrying struct stm32mp_boot_stats */
+#define STM32MP_TL_TAG_BOOT_STATS	U(0xff01)
+#define STM32MP_BOOT_STATS_VERSION	U(1)
+#define STM32MP_BOOT_STATS_MAX_IMAGES	U(16)
+
+/*
+ * Per-image record. Certificates loaded while authenticating an image are
+ * accounted to that image. load_ticks excludes the time spent in the crypto
+ * library, which is reported in auth_ticks.
+ */
+struct stm32mp_boot_stats_image {
+	uint32_t image_id;
+	uint32_t size;
+	uint64_t load_ticks;
+	uint64_t auth_ticks;
+};
+
+struct stm32mp_boot_stats {
+	uint32_t version;
+	uint32_t nb_images;
+	uint64_t cnt_freq;
+	uint64_t bl2_entry;
+	uint64_t bl2_exit;
+	uint64_t phase_ticks[STM32MP_BOOT_PHASE_NB];
+	struct stm32mp_boot_stats_image image[STM32MP_BOOT_STATS_MAX_IMAGES];
+};
+
+/* Fields returned by the STM32_SIP_SMC_BOOT_STATS service, in microseconds */
+#define STM32MP_BOOT_STATS_NB_IMAGES	U(0)
+#define STM32MP_BOOT_STATS_BL2_ENTRY	U(1)
+#define STM32MP_BOOT_STATS_BL2_TIME	U(2)
+#define STM32MP_BOOT_STATS_CLK_TIME	U(3)
+#define STM32MP_BOOT_STATS_DDR_TIME	U(4)
+
+#define STM32MP_BOOT_STATS_IMAGE_ID	U(0)
+#define STM32MP_BOOT_STATS_IMAGE_SIZE	U(1)
+#define STM32MP_BOOT_STATS_IMAGE_LOAD	U(2)
+#define STM32MP_BOOT_STATS_IMAGE_AUTH	U(3)
+
+#if STM32MP_BOOT_STATS
+#if defined(IMAGE_BL2)
+void stm32mp_boot_stats_init(void);
+void stm32mp_boot_stats_phase_start(unsigned int phase);
+void stm32mp_boot_stats_phase_end(unsigned int phase);
+void stm32mp_boot_stats_image_start(unsigned int image_id);
+void stm32mp_boot_stats_image_end(unsigned int image_id, uint32_t size);
+uint64_t stm32mp_boot_stats_auth_start(void);
+void stm32mp_boot_stats_auth_end(uint64_t start);
+uintptr_t stm32mp_boot_stats_publish(void);
+#endif /* IMAGE_BL2 */
+
+#if defined(IMAGE_BL31)
+void stm32mp_boot_stats_import(uintptr_t tl_addr);
+uint32_t stm32mp_boot_stats_get(u_register_t index, u_register_t field,
+				uint32_t *value);
+#endif /* IMAGE_BL31 */
+#else /* STM32MP_BOOT_STATS */
+static inline void stm32mp_boot_stats_init(void)
+{
+}
+
+static inline void stm32mp_boot_stats_phase_start(unsigned int phase)
+{
+}
+
+static inline void stm32mp_boot_stats_phase_end(unsigned int phase)
+{
+}
+
+static inline void stm32mp_boot_stats_image_start(unsigned int image_id)
+{
+}
+
+static inline void stm32mp_boot_stats_image_end(unsigned int image_id,
+						uint32_t size)
+{
+}
+#endif /* STM32MP_BOOT_STATS */
+
+#endif /* STM32MP_BOOT_STATS_H */
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2024, STMicroelectronics - All Rights Reserved
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/pmf/pmf.h>
+#include <lib/transfer_list.h>
+
+#include <platform_def.h>
+#include <stm32mp_boot_stats.h>
+#include <stm32mp_svc_setup.h>
+
+#define BOOT_STATS_TL_SIZE	U(512)
+
+static struct stm32mp_boot_stats boot_stats;
+
+static uint32_t boot_stats_ticks_to_us(uint64_t ticks)
+{
+	uint64_t us;
+
+	if (boot_stats.cnt_freq == 0U) {
+		return 0U;
+	}
+
+	us = (ticks * 1000000ULL) / boot_stats.cnt_freq;
+	if (us > UINT32_MAX) {
+		return UINT32_MAX;
+	}
+
+	return (uint32_t)us;
+}
+
+#if defined(IMAGE_BL2)
+#if ENABLE_PMF
+PMF_REGISTER_SERVICE(stm32mp_boot_svc, STM32MP_PMF_BOOT_SVC_ID,
+		     STM32MP_BOOT_TS_NB, PMF_DUMP_ENABLE);
+#endif
+
+static uint64_t phase_start[STM32MP_BOOT_PHASE_NB];
+static uint64_t image_start;
+static uint64_t image_auth;
+static uint8_t boot_stats_tl[BOOT_STATS_TL_SIZE] __aligned(8);
+
+static uint64_t boot_stats_capture(unsigned int tid __unused)
+{
+	unsigned long long ts;
+
+#if ENABLE_PMF
+	PMF_CAPTURE_AND_GET_TIMESTAMP(stm32mp_boot_svc, tid, PMF_NO_CACHE_MAINT, ts);
+#else
+	ts = read_cntpct_el0();
+#endif
+
+	return ts;
+}
+
+void stm32mp_boot_stats_init(void)
+{
+	boot_stats.version = STM32MP_BOOT_STATS_VERSION;
+	boot_stats.bl2_entry = read_cntpct_el0();
+}
+
+void stm32mp_boot_stats_phase_start(unsigned int phase)
+{
+	assert(phase < STM32MP_BOOT_PHASE_NB);
+
+	phase_start[phase] = boot_stats_capture(phase * 2U);
+}
+
+void stm32mp_boot_stats_phase_end(unsigned int phase)
+{
+	assert(phase < STM32MP_BOOT_PHASE_NB);
+
+	boot_stats.phase_ticks[phase] += boot_stats_capture((phase * 2U) + 1U) -
+					 phase_start[phase];
+}
+
+void stm32mp_boot_stats_image_start(unsigned int image_id __unused)
+{
+	image_auth = 0U;
+	image_start = read_cntpct_el0();
+}
+
+void stm32mp_boot_stats_image_end(unsigned int image_id, uint32_t size)
+{
+	uint64_t elapsed = read_cntpct_el0() - image_start;
+	struct stm32mp_boot_stats_image *image;
+
+	/* Images skipped at this boot are not reported */
+	if (size == 0U) {
+		return;
+	}
+
+	if (boot_stats.nb_images >= STM32MP_BOOT_STATS_MAX_IMAGES) {
+		VERBOSE("Boot stats: no slot for image %u\n", image_id);
+		return;
+	}
+
+	image = &boot_stats.image[boot_stats.nb_images];
+	image->image_id = image_id;
+	image->size = size;
+	image->auth_ticks = image_auth;
+	image->load_ticks = (elapsed > image_auth) ? (elapsed - image_auth) : 0U;
+	boot_stats.nb_images++;
+}
+
+uint64_t stm32mp_boot_stats_auth_start(void)
+{
+	return read_cntpct_el0();
+}
+
+void stm32mp_boot_stats_auth_end(uint64_t start)
+{
+	image_auth += read_cntpct_el0() - start;
+}
+
+static void boot_stats_print(void)
+{
+	unsigned int i;
+
+	INFO("BL2: clock setup %u us, DDR init %u us, total %u us\n",
+	     boot_stats_ticks_to_us(boot_stats.phase_ticks[STM32MP_BOOT_PHASE_CLK]),
+	     boot_stats_ticks_to_us(boot_stats.phase_ticks[STM32MP_BOOT_PHASE_DDR]),
+	     boot_stats_ticks_to_us(boot_stats.bl2_exit - boot_stats.bl2_entry));
+
+	for (i = 0U; i < boot_stats.nb_images; i++) {
+		const struct stm32mp_boot_stats_image *image = &boot_stats.image[i];
+		uint32_t load_us = boot_stats_ticks_to_us(image->load_ticks);
+		uint32_t kib_s = 0U;
+
+		if (load_us != 0U) {
+			kib_s = (uint32_t)(((uint64_t)image->size * 1000000ULL) /
+					   ((uint64_t)load_us * 1024U));
+		}
+
+		INFO("BL2: image %u: %u bytes, load %u us (%u KiB/s), auth %u us\n",
+		     image->image_id, image->size, load_us, kib_s,
+		     boot_stats_ticks_to_us(image->auth_ticks));
+	}
+}
+
+/*
+ * Store the statistics in a transfer list located in BL2 RW data, which is
+ * preserved until BL31 early setup. Return the transfer list address, or 0
+ * on failure.
+ */
+uintptr_t stm32mp_boot_stats_publish(void)
+{
+	struct transfer_list_header *tl;
+
+	boot_stats.cnt_freq = read_cntfrq_el0();
+	boot_stats.bl2_exit = read_cntpct_el0();
+
+	boot_stats_print();
+
+	tl = transfer_list_init(boot_stats_tl, sizeof(boot_stats_tl));
+	if (tl == NULL) {
+		return 0U;
+	}
+
+	if (transfer_list_add(tl, STM32MP_TL_TAG_BOOT_STATS, sizeof(boot_stats),
+			      &boot_stats) == NULL) {
+		WARN("Boot stats: cannot add transfer list entry\n");
+		return 0U;
+	}
+
+	return (uintptr_t)tl;
+}
+#endif /* IMAGE_BL2 */
+
+#if defined(IMAGE_BL31)
+static bool boot_stats_valid;
+
+/*
+ * Copy the statistics from the transfer list passed by BL2. Must be called
+ * while the BL2 area is still mapped.
+ */
+void stm32mp_boot_stats_import(uintptr_t tl_addr)
+{
+	struct transfer_list_header *tl = (struct transfer_list_header *)tl_addr;
+	struct transfer_list_entry *te;
+
+	if ((tl == NULL) || (transfer_list_check_header(tl) == TL_OPS_NON)) {
+		return;
+	}
+
+	te = transfer_list_find(tl, STM32MP_TL_TAG_BOOT_STATS);
+	if ((te == NULL) || (te->data_size != sizeof(boot_stats))) {
+		return;
+	}
+
+	memcpy(&boot_stats, transfer_list_entry_data(te), sizeof(boot_stats));
+
+	if ((boot_stats.version != STM32MP_BOOT_STATS_VERSION) ||
+	    (boot_stats.nb_images > STM32MP_BOOT_STATS_MAX_IMAGES)) {
+		return;
+	}
+
+	boot_stats_valid = true;
+}
+
+/*
+ * Index 0 selects the global BL2 fields, index N the N-th loaded image.
+ * Durations are returned in microseconds.
+ */
+uint32_t stm32mp_boot_stats_get(u_register_t index, u_register_t field,
+				uint32_t *value)
+{
+	const struct stm32mp_boot_stats_image *image;
+
+	if (!boot_stats_valid) {
+		return STM32_SMC_FAILED;
+	}
+
+	if (index == 0U) {
+		switch (field) {
+		case STM32MP_BOOT_STATS_NB_IMAGES:
+			*value = boot_stats.nb_images;
+			break;
+		case STM32MP_BOOT_STATS_BL2_ENTRY:
+			*value = boot_stats_ticks_to_us(boot_stats.bl2_entry);
+			break;
+		case STM32MP_BOOT_STATS_BL2_TIME:
+			*value = boot_stats_ticks_to_us(boot_stats.bl2_exit -
+							boot_stats.bl2_entry);
+			break;
+		case STM32MP_BOOT_STATS_CLK_TIME:
+			*value = boot_stats_ticks_to_us(boot_stats.phase_ticks[STM32MP_BOOT_PHASE_CLK]);
+			break;
+		case STM32MP_BOOT_STATS_DDR_TIME:
+			*value = boot_stats_ticks_to_us(boot_stats.phase_ticks[STM32MP_BOOT_PHASE_DDR]);
+			break;
+		default:
+			return STM32_SMC_INVALID_PARAMS;
+		}
+
+		return STM32_SMC_OK;
+	}
+
+	if (index > boot_stats.nb_images) {
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	image = &boot_stats.image[index - 1U];
+
+	switch (field) {
+	case STM32MP_BOOT_STATS_IMAGE_ID:
+		*value = image->image_id;
+		break;
+	case STM32MP_BOOT_STATS_IMAGE_SIZE:
+		*value = image->size;
+		break;
+	case STM32MP_BOOT_STATS_IMAGE_LOAD:
+		*value = boot_stats_ticks_to_us(image->load_ticks);
+		break;
+	case STM32MP_BOOT_STATS_IMAGE_AUTH:
+		*value = boot_stats_ticks_to_us(image->auth_ticks);
+		break;
+	default:
+		return STM32_SMC_INVALID_PARAMS;
+	}
+
+	return STM32_SMC_OK;
+}
+#endif /* IMAGE_BL31 */
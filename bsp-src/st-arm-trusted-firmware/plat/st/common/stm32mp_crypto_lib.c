@@ -26,6 +26,7 @@
 #include <tools_share/firmware_encrypted.h>
 
 #include <platform_def.h>
+#include <stm32mp_boot_stats.h>
 
 #define CRYPTO_HASH_MAX_SIZE	32U
 #define CRYPTO_SIGN_MAX_SIZE	64U
@@ -481,6 +482,164 @@ static int crypto_verify_hash(void *data_ptr, unsigned int data_len,
 	return ret;
 }
 
+/* Expected digest of the incremental hash verification in progress */
+static uint8_t *stream_digest;
+
+static int crypto_verify_hash_start(void *digest_info_ptr,
+				    unsigned int digest_info_len)
+{
+	int ret;
+	unsigned char *p;
+	mbedtls_md_type_t md_alg;
+	size_t len;
+
+	assert(stream_digest == NULL);
+
+	ret = get_plain_digest_from_asn1(digest_info_ptr, digest_info_len,
+					 &p, &len, &md_alg);
+	if ((ret != 0) || (md_alg != MBEDTLS_MD_SHA256) ||
+	    (len != BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES)) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	stm32_hash_init(HASH_SHA256);
+	stream_digest = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(stream_digest != NULL);
+
+	if (stm32_hash_update(data_ptr, data_len) != 0) {
+		VERBOSE("%s: hash failed\n", __func__);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_verify_hash_finish(void)
+{
+	uint8_t calc_hash[BOOT_API_SHA256_DIGEST_SIZE_IN_BYTES];
+	uint8_t *digest = stream_digest;
+	int ret;
+
+	assert(digest != NULL);
+
+	stream_digest = NULL;
+
+	ret = stm32_hash_final(calc_hash);
+	if (ret != 0) {
+		VERBOSE("%s: hash failed\n", __func__);
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (memcmp(calc_hash, digest, sizeof(calc_hash)) != 0) {
+		VERBOSE("%s: not expected digest\n", __func__);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int crypto_calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
+			    unsigned int data_len,
+			    unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	enum stm32_hash_algo_mode mode;
+
+	switch (md_algo) {
+	case CRYPTO_MD_SHA256:
+		mode = HASH_SHA256;
+		break;
+#if STM32_HASH_VER == 4
+	case CRYPTO_MD_SHA384:
+		mode = HASH_SHA384;
+		break;
+	case CRYPTO_MD_SHA512:
+		mode = HASH_SHA512;
+		break;
+#endif
+	default:
+		return CRYPTO_ERR_HASH;
+	}
+
+	stm32_hash_init(mode);
+
+	if (stm32_hash_final_update(data_ptr, data_len, output) != 0) {
+		VERBOSE("%s: hash failed\n", __func__);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+#if STM32MP_BOOT_STATS
+/* Account the time spent in verification to the image being loaded */
+static int crypto_verify_signature_stats(void *data_ptr, unsigned int data_len,
+					 void *sig_ptr, unsigned int sig_len,
+					 void *sig_alg, unsigned int sig_alg_len,
+					 void *pk_ptr, unsigned int pk_len)
+{
+	uint64_t start = stm32mp_boot_stats_auth_start();
+	int ret;
+
+	ret = crypto_verify_signature(data_ptr, data_len, sig_ptr, sig_len,
+				      sig_alg, sig_alg_len, pk_ptr, pk_len);
+	stm32mp_boot_stats_auth_end(start);
+
+	return ret;
+}
+
+static int crypto_verify_hash_stats(void *data_ptr, unsigned int data_len,
+				    void *digest_info_ptr,
+				    unsigned int digest_info_len)
+{
+	uint64_t start = stm32mp_boot_stats_auth_start();
+	int ret;
+
+	ret = crypto_verify_hash(data_ptr, data_len, digest_info_ptr,
+				 digest_info_len);
+	stm32mp_boot_stats_auth_end(start);
+
+	return ret;
+}
+
+static int crypto_verify_hash_update_stats(void *data_ptr, unsigned int data_len)
+{
+	uint64_t start = stm32mp_boot_stats_auth_start();
+	int ret;
+
+	ret = crypto_verify_hash_update(data_ptr, data_len);
+	stm32mp_boot_stats_auth_end(start);
+
+	return ret;
+}
+
+static int crypto_verify_hash_finish_stats(void)
+{
+	uint64_t start = stm32mp_boot_stats_auth_start();
+	int ret;
+
+	ret = crypto_verify_hash_finish();
+	stm32mp_boot_stats_auth_end(start);
+
+	return ret;
+}
+
+#define CRYPTO_VERIFY_SIGNATURE		crypto_verify_signature_stats
+#define CRYPTO_VERIFY_HASH		crypto_verify_hash_stats
+#define CRYPTO_VERIFY_HASH_UPDATE	crypto_verify_hash_update_stats
+#define CRYPTO_VERIFY_HASH_FINISH	crypto_verify_hash_finish_stats
+#else /* STM32MP_BOOT_STATS */
+#define CRYPTO_VERIFY_SIGNATURE		crypto_verify_signature
+#define CRYPTO_VERIFY_HASH		crypto_verify_hash
+#define CRYPTO_VERIFY_HASH_UPDATE	crypto_verify_hash_update
+#define CRYPTO_VERIFY_HASH_FINISH	crypto_verify_hash_finish
+#endif /* STM32MP_BOOT_STATS */
+
 #if !defined(DECRYPTION_SUPPORT_none)
 static int derive_key(uint8_t *key, size_t *key_len, size_t len,
 		      unsigned int *flags, const uint8_t *img_id, size_t img_id_len)
@@ -654,20 +813,26 @@ static int crypto_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr, si
 	return CRYPTO_SUCCESS;
 }
 
-REGISTER_CRYPTO_LIB("stm32_crypto_lib",
-		    crypto_lib_init,
-		    crypto_verify_signature,
-		    crypto_verify_hash,
-		    NULL,
-		    crypto_auth_decrypt,
-		    crypto_convert_pk);
+REGISTER_CRYPTO_LIB_HASH_UPDATE("stm32_crypto_lib",
+				crypto_lib_init,
+				CRYPTO_VERIFY_SIGNATURE,
+				CRYPTO_VERIFY_HASH,
+				crypto_calc_hash,
+				crypto_auth_decrypt,
+				crypto_convert_pk,
+				crypto_verify_hash_start,
+				CRYPTO_VERIFY_HASH_UPDATE,
+				CRYPTO_VERIFY_HASH_FINISH);
 
 #else /* No decryption support */
-REGISTER_CRYPTO_LIB("stm32_crypto_lib",
-		    crypto_lib_init,
-		    crypto_verify_signature,
-		    crypto_verify_hash,
-		    NULL,
-		    NULL,
-		    crypto_convert_pk);
+REGISTER_CRYPTO_LIB_HASH_UPDATE("stm32_crypto_lib",
+				crypto_lib_init,
+				CRYPTO_VERIFY_SIGNATURE,
+				CRYPTO_VERIFY_HASH,
+				crypto_calc_hash,
+				NULL,
+				crypto_convert_pk,
+				crypto_verify_hash_start,
+				CRYPTO_VERIFY_HASH_UPDATE,
+				CRYPTO_VERIFY_HASH_FINISH);
 #endif
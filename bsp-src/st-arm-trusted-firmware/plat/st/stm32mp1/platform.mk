@@ -10,6 +10,10 @@ STM32_EXTRA_PARTS	:=	4
 
 include plat/st/common/common.mk
 
+ifeq (${STM32MP_BOOT_STATS},1)
+$(error "STM32MP_BOOT_STATS not supported on STM32MP1")
+endif
+
 ARM_CORTEX_A7		:=	yes
 ARM_WITH_NEON		:=	yes
 USE_COHERENT_MEM	:=	0
@@ -39,6 +39,7 @@
 #include <plat/common/platform.h>
 
 #include <platform_def.h>
+#include <stm32mp_boot_stats.h>
 #include <stm32mp_common.h>
 #include <stm32mp_dt.h>
 #include <stm32mp2_context.h>
@@ -187,6 +188,8 @@ void bl2_el3_early_platform_setup(u_register_t arg0 __unused,
 				  u_register_t arg2 __unused,
 				  u_register_t arg3 __unused)
 {
+	stm32mp_boot_stats_init();
+
 	stm32mp_setup_early_console();
 
 	stm32mp_save_boot_ctx_address(BOOT_CTX_ADDR);
@@ -199,7 +202,9 @@ void bl2_platform_setup(void)
 	int ret;
 
 #if !STM32MP_M33_TDCID
+	stm32mp_boot_stats_phase_start(STM32MP_BOOT_PHASE_DDR);
 	ret = stm32mp2_ddr_probe();
+	stm32mp_boot_stats_phase_end(STM32MP_BOOT_PHASE_DDR);
 	if (ret != 0) {
 		ERROR("DDR probe: error %d\n", ret);
 		panic();
@@ -400,6 +405,8 @@ void bl2_el3_plat_arch_setup(void)
 
 	reset_backup_domain();
 
+	stm32mp_boot_stats_phase_start(STM32MP_BOOT_PHASE_CLK);
+
 #if !STM32MP_M33_TDCID
 	/*
 	 * Initialize DDR sub-system clock. This needs to be done before enabling DDR PLL (PLL2),
@@ -412,6 +419,8 @@ void bl2_el3_plat_arch_setup(void)
 		panic();
 	}
 
+	stm32mp_boot_stats_phase_end(STM32MP_BOOT_PHASE_CLK);
+
 #if STM32MP_DDR_FIP_IO_STORAGE || TRUSTED_BOARD_BOOT
 #if !STM32MP_M33_TDCID
 	/*
@@ -615,6 +624,10 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 
 	assert(bl_mem_params != NULL);
 
+	if ((bl_mem_params->image_info.h.attr & IMAGE_ATTRIB_SKIP_LOADING) == 0U) {
+		stm32mp_boot_stats_image_end(image_id, bl_mem_params->image_info.image_size);
+	}
+
 #if STM32MP_SDMMC || STM32MP_EMMC
 	/*
 	 * Invalidate remaining data read from MMC but not flushed by load_image_flush().
@@ -16,6 +16,7 @@
 #include <plat/common/platform.h>
 
 #include <platform_def.h>
+#include <stm32mp_boot_stats.h>
 #include <stm32mp2_context.h>
 
 static entry_point_info_t bl32_image_ep_info;
@@ -120,6 +121,10 @@ void bl31_early_platform_setup2(u_register_t arg0, u_register_t arg1,
 		bl_params = bl_params->next_params_info;
 	}
 
+#if STM32MP_BOOT_STATS
+	stm32mp_boot_stats_import(arg3);
+#endif
+
 	ret = mmap_remove_dynamic_region(STM32MP_SYSRAM_BASE + STM32MP_SYSRAM_SIZE / 2U,
 					 STM32MP_SYSRAM_SIZE / 2U);
 	if (ret < 0) {
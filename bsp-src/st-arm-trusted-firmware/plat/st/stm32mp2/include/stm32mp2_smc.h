@@ -7,7 +7,11 @@
 #ifndef STM32MP2_SMC_H
 #define STM32MP2_SMC_H
 
+#if STM32MP_BOOT_STATS
+#define STM32_COMMON_SIP_NUM_CALLS			2U
+#else
 #define STM32_COMMON_SIP_NUM_CALLS			1U
+#endif
 
 /*
  * STM32_SIP_SMC_STGEN_SET_RATE call API
@@ -19,4 +23,16 @@
  */
 #define STM32_SIP_SMC_STGEN_SET_RATE                    0x82000000
 
+/*
+ * STM32_SIP_SMC_BOOT_STATS call API
+ * Only available with STM32MP_BOOT_STATS=1.
+ *
+ * Argument a0: (input) SMCC ID
+ *		(output) status return code
+ * Argument a1: (input) 0 for BL2 global statistics, N for the Nth loaded image
+ *		(output) requested value, see STM32MP_BOOT_STATS_* fields
+ * Argument a2: (input) field identifier
+ */
+#define STM32_SIP_SMC_BOOT_STATS			0x82000001
+
 #endif /* STM32MP2_SMC_H */
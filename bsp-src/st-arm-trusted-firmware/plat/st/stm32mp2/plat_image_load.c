@@ -8,6 +8,8 @@
 #include <common/desc_image_load.h>
 #include <plat/common/platform.h>
 
+#include <stm32mp_boot_stats.h>
+
 /*******************************************************************************
  * This function flushes the data structures so that they are visible
  * in memory for the next BL image.
@@ -34,5 +36,10 @@ bl_params_t *plat_get_next_bl_params(void)
 
 	populate_next_bl_params_config(bl_params);
 
+#if STM32MP_BOOT_STATS
+	/* BL31 retrieves the BL2 boot statistics from arg3 */
+	bl_params->head->ep_info->args.arg3 = stm32mp_boot_stats_publish();
+#endif
+
 	return bl_params;
 }
@@ -346,6 +346,16 @@ BL2_SOURCES			+=	drivers/st/ddr/phy/phyinit/src/ddrphy_phyinit_d_loadimem.c				\
 					drivers/st/ddr/phy/phyinit/usercustom/ddrphy_phyinit_usercustom_g_waitfwdone.c
 endif #STM32MP_M33_TDCID
 
+ifeq (${STM32MP_BOOT_STATS},1)
+# Boot statistics are handed over from BL2 to BL31 in a transfer list
+ifneq (${TRANSFER_LIST},1)
+BL2_SOURCES			+=	lib/transfer_list/transfer_list.c
+BL31_SOURCES			+=	lib/transfer_list/transfer_list.c
+endif
+BL2_SOURCES			+=	plat/st/common/stm32mp_boot_stats.c
+BL31_SOURCES			+=	plat/st/common/stm32mp_boot_stats.c
+endif
+
 # BL31 sources
 BL31_SOURCES			+=	${FDT_WRAPPERS_SOURCES}
 
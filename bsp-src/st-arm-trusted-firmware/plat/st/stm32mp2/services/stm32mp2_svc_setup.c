@@ -11,6 +11,7 @@
 #include <common/runtime_svc.h>
 #include <lib/mmio.h>
 
+#include <stm32mp_boot_stats.h>
 #include <stm32mp_svc_setup.h>
 #include <stm32mp2_smc.h>
 
@@ -38,6 +39,12 @@ void plat_svc_smc_handler(uint32_t smc_fid, u_register_t x1,
 
 		*ret1 = stgen_svc_handler();
 		break;
+#if STM32MP_BOOT_STATS
+	case STM32_SIP_SMC_BOOT_STATS:
+		*ret1 = stm32mp_boot_stats_get(x1, x2, ret2);
+		*ret2_enabled = (*ret1 == STM32_SMC_OK);
+		break;
+#endif
 	default:
 		WARN("Unimplemented STM32MP2 Service Call: 0x%x\n", smc_fid);
 		*ret1 = STM32_SMC_NOT_SUPPORTED;
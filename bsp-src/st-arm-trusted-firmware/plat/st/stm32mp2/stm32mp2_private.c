@@ -98,7 +98,7 @@ static uint8_t saved_header[STM32MP_HEADER_SIZE] __maybe_unused;
 
 void configure_mmu(void)
 {
-	mmap_add(stm32mp2_mmap);
+	mmap_add_bulk(stm32mp2_mmap);
 	init_xlat_tables();
 
 	enable_mmu_el3(0);
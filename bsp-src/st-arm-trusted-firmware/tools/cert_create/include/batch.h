@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/* Option given for one variant in the batch manifest */
+typedef struct batch_opt_s {
+	char *name;		/* Long option name, without the leading "--" */
+	char *arg;		/* Option argument */
+} batch_opt_t;
+
+/*
+ * One line of the batch manifest. Each variant is a list of image and
+ * certificate options overriding the ones given on the command line.
+ */
+typedef struct batch_variant_s {
+	int line;		/* Line number in the manifest */
+	int num_opts;
+	batch_opt_t *opts;
+} batch_variant_t;
+
+typedef void (*batch_job_fn_t)(int idx, void *arg);
+
+/* Exported API */
+int batch_load(const char *filename, batch_variant_t **variants,
+	       int *num_variants);
+void batch_free(batch_variant_t *variants, int num_variants);
+void batch_run_jobs(int num_jobs, int num_threads, batch_job_fn_t fn,
+		    void *arg);
+int batch_num_cpus(void);
+double batch_time_ms(void);
+
+#endif /* BATCH_H */
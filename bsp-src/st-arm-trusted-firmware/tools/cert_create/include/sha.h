@@ -8,5 +8,8 @@
 #define SHA_H
 
 int sha_file(int md_alg, const char *filename, unsigned char *md);
+int sha_file_cached(int md_alg, const char *filename, unsigned char *md);
+void sha_cache_stats(unsigned int *hits, unsigned int *misses);
+void sha_cache_cleanup(void);
 
 #endif /* SHA_H */
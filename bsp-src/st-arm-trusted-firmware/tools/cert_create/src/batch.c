@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* getline(), clock_gettime() and the pthread API are not part of C99 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "batch.h"
+#include "debug.h"
+
+/* Work shared by the threads of batch_run_jobs() */
+typedef struct batch_queue_s {
+	pthread_mutex_t lock;
+	int next;
+	int num_jobs;
+	batch_job_fn_t fn;
+	void *arg;
+} batch_queue_t;
+
+static char *next_token(char **p)
+{
+	char *tok = *p;
+
+	while (isspace((unsigned char)*tok)) {
+		tok++;
+	}
+	if (*tok == '\0') {
+		*p = tok;
+		return NULL;
+	}
+
+	*p = tok;
+	while ((**p != '\0') && !isspace((unsigned char)**p)) {
+		(*p)++;
+	}
+	if (**p != '\0') {
+		*(*p)++ = '\0';
+	}
+
+	return tok;
+}
+
+static char *batch_strdup(const char *str)
+{
+	char *dup = malloc(strlen(str) + 1);
+
+	if (dup == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
+	return strcpy(dup, str);
+}
+
+static int parse_line(char *line, int line_num, batch_variant_t *variant)
+{
+	char *p = line, *tok, *arg;
+	batch_opt_t *opt;
+
+	variant->line = line_num;
+	variant->num_opts = 0;
+	variant->opts = NULL;
+
+	while ((tok = next_token(&p)) != NULL) {
+		if (strncmp(tok, "--", 2) != 0) {
+			ERROR("Line %d: expected an option, got '%s'\n",
+			      line_num, tok);
+			return 1;
+		}
+		tok += 2;
+
+		/* Accept both "--opt value" and "--opt=value" */
+		arg = strchr(tok, '=');
+		if (arg != NULL) {
+			*arg++ = '\0';
+		} else {
+			arg = next_token(&p);
+			if (arg == NULL) {
+				ERROR("Line %d: missing argument for '--%s'\n",
+				      line_num, tok);
+				return 1;
+			}
+		}
+
+		variant->opts = realloc(variant->opts,
+				(variant->num_opts + 1) * sizeof(*opt));
+		if (variant->opts == NULL) {
+			ERROR("%s:%d Failed to allocate memory.\n",
+			      __func__, __LINE__);
+			exit(1);
+		}
+		opt = &variant->opts[variant->num_opts++];
+		opt->name = batch_strdup(tok);
+		opt->arg = batch_strdup(arg);
+	}
+
+	return 0;
+}
+
+/*
+ * Load a batch manifest. Each line describes one variant with the same long
+ * options as the command line, separated by blanks. Empty lines and lines
+ * starting with '#' are ignored.
+ *
+ * Return: 0 = success, Otherwise: error
+ */
+int batch_load(const char *filename, batch_variant_t **variants,
+	       int *num_variants)
+{
+	FILE *file;
+	char *line = NULL, *p;
+	size_t line_size = 0;
+	int line_num = 0, ret = 0;
+	batch_variant_t *v = NULL;
+	int num = 0;
+
+	file = fopen(filename, "r");
+	if (file == NULL) {
+		ERROR("Cannot open batch manifest %s\n", filename);
+		return 1;
+	}
+
+	while (getline(&line, &line_size, file) != -1) {
+		line_num++;
+
+		p = line;
+		while (isspace((unsigned char)*p)) {
+			p++;
+		}
+		if ((*p == '\0') || (*p == '#')) {
+			continue;
+		}
+
+		v = realloc(v, (num + 1) * sizeof(*v));
+		if (v == NULL) {
+			ERROR("%s:%d Failed to allocate memory.\n",
+			      __func__, __LINE__);
+			exit(1);
+		}
+		ret = parse_line(p, line_num, &v[num]);
+		num++;
+		if (ret != 0) {
+			break;
+		}
+	}
+
+	free(line);
+	fclose(file);
+
+	if ((ret == 0) && (num == 0)) {
+		ERROR("No variant found in %s\n", filename);
+		ret = 1;
+	}
+	if (ret != 0) {
+		batch_free(v, num);
+		return ret;
+	}
+
+	*variants = v;
+	*num_variants = num;
+
+	return 0;
+}
+
+void batch_free(batch_variant_t *variants, int num_variants)
+{
+	int i, j;
+
+	for (i = 0; i < num_variants; i++) {
+		for (j = 0; j < variants[i].num_opts; j++) {
+			free(variants[i].opts[j].name);
+			free(variants[i].opts[j].arg);
+		}
+		free(variants[i].opts);
+	}
+	free(variants);
+}
+
+static void *batch_worker(void *arg)
+{
+	batch_queue_t *queue = arg;
+	int idx;
+
+	while (1) {
+		pthread_mutex_lock(&queue->lock);
+		idx = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+
+		if (idx >= queue->num_jobs) {
+			break;
+		}
+		queue->fn(idx, queue->arg);
+	}
+
+	return NULL;
+}
+
+/*
+ * Run fn(0) to fn(num_jobs - 1) on up to num_threads threads, the calling
+ * thread included. The jobs must be independent from each other.
+ */
+void batch_run_jobs(int num_jobs, int num_threads, batch_job_fn_t fn,
+		    void *arg)
+{
+	batch_queue_t queue;
+	pthread_t *threads;
+	int i;
+
+	if (num_threads > num_jobs) {
+		num_threads = num_jobs;
+	}
+
+	if (num_threads <= 1) {
+		for (i = 0; i < num_jobs; i++) {
+			fn(i, arg);
+		}
+		return;
+	}
+
+	queue.next = 0;
+	queue.num_jobs = num_jobs;
+	queue.fn = fn;
+	queue.arg = arg;
+	if (pthread_mutex_init(&queue.lock, NULL) != 0) {
+		ERROR("Cannot initialize the job queue\n");
+		exit(1);
+	}
+
+	threads = malloc(num_threads * sizeof(*threads));
+	if (threads == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
+	for (i = 1; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, batch_worker,
+				   &queue) != 0) {
+			ERROR("Cannot create worker thread\n");
+			exit(1);
+		}
+	}
+	batch_worker(&queue);
+	for (i = 1; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&queue.lock);
+	free(threads);
+}
+
+int batch_num_cpus(void)
+{
+	long num = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (num < 1) ? 1 : (int)num;
+}
+
+double batch_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ts.tv_sec * 1000.0) + (ts.tv_nsec / 1000000.0);
+}
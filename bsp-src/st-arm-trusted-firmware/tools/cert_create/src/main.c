@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,6 +20,7 @@
 #include <openssl/sha.h>
 #include <openssl/x509v3.h>
 
+#include "batch.h"
 #include "cert.h"
 #include "cmd_opt.h"
 #include "debug.h"
@@ -65,6 +67,13 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int num_threads;
+static const char *batch_file;
+static const EVP_MD *md_info;
+static unsigned int md_len;
+
+/* Image hashes of the current certificates, indexed by extension */
+static unsigned char (*image_md)[SHA512_DIGEST_LENGTH];
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -161,6 +170,18 @@ static int get_key_size(const char *key_size_str)
 	return key_size;
 }
 
+static int get_num_threads(const char *num_threads_str)
+{
+	char *end;
+	long num;
+
+	num = strtol(num_threads_str, &end, 10);
+	if ((*end != '\0') || (num < 0) || (num > INT_MAX))
+		return -1;
+
+	return num;
+}
+
 static int get_hash_alg(const char *hash_alg_str)
 {
 	int i;
@@ -174,39 +195,12 @@ static int get_hash_alg(const char *hash_alg_str)
 	return -1;
 }
 
-static void check_cmd_params(void)
+static void check_cert_params(void)
 {
 	cert_t *cert;
 	ext_t *ext;
 	key_t *key;
 	int i, j;
-	bool valid_size;
-
-	/* Only save new keys */
-	if (save_keys && !new_keys) {
-		ERROR("Only new keys can be saved to disk\n");
-		exit(1);
-	}
-
-	/* Validate key-size */
-	valid_size = false;
-	for (i = 0; i < KEY_SIZE_MAX_NUM; i++) {
-		if (key_size == KEY_SIZES[key_alg][i]) {
-			valid_size = true;
-			break;
-		}
-	}
-	if (!valid_size) {
-		ERROR("'%d' is not a valid key size for '%s'\n",
-				key_size, key_algs_str[key_alg]);
-		NOTICE("Valid sizes are: ");
-		for (i = 0; i < KEY_SIZE_MAX_NUM &&
-				KEY_SIZES[key_alg][i] != 0; i++) {
-			printf("%d ", KEY_SIZES[key_alg][i]);
-		}
-		printf("\n");
-		exit(1);
-	}
 
 	/* Check that all required options have been specified in the
 	 * command line */
@@ -261,6 +255,43 @@ static void check_cmd_params(void)
 	}
 }
 
+static void check_cmd_params(void)
+{
+	int i;
+	bool valid_size;
+
+	/* Only save new keys */
+	if (save_keys && !new_keys) {
+		ERROR("Only new keys can be saved to disk\n");
+		exit(1);
+	}
+
+	/* Validate key-size */
+	valid_size = false;
+	for (i = 0; i < KEY_SIZE_MAX_NUM; i++) {
+		if (key_size == KEY_SIZES[key_alg][i]) {
+			valid_size = true;
+			break;
+		}
+	}
+	if (!valid_size) {
+		ERROR("'%d' is not a valid key size for '%s'\n",
+				key_size, key_algs_str[key_alg]);
+		NOTICE("Valid sizes are: ");
+		for (i = 0; i < KEY_SIZE_MAX_NUM &&
+				KEY_SIZES[key_alg][i] != 0; i++) {
+			printf("%d ", KEY_SIZES[key_alg][i]);
+		}
+		printf("\n");
+		exit(1);
+	}
+
+	/* Batch variants are checked one by one */
+	if (batch_file == NULL) {
+		check_cert_params();
+	}
+}
+
 /* Common command line options */
 static const cmd_opt_t common_cmd_opt[] = {
 	{
@@ -291,25 +322,431 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "batch", required_argument, NULL, 'B' },
+		"Generate the certificates of all the variants listed in the " \
+		"given manifest, one line of image and certificate options " \
+		"per variant"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to hash images and sign certificates " \
+		"(default: number of CPUs)"
 	}
 };
 
-int main(int argc, char *argv[])
+static void load_keys(void)
+{
+	unsigned int err_code;
+	int i;
+
+	/* Load private keys from files (or generate new ones) */
+	for (i = 0 ; i < num_keys ; i++) {
+#if !USING_OPENSSL3
+		if (!key_new(&keys[i])) {
+			ERROR("Failed to allocate key container\n");
+			exit(1);
+		}
+#endif
+
+		/* First try to load the key from disk */
+		err_code = key_load(&keys[i]);
+		if (err_code == KEY_ERR_NONE) {
+			/* Key loaded successfully */
+			continue;
+		}
+
+		/* Key not loaded. Check the error code */
+		if (err_code == KEY_ERR_LOAD) {
+			/* File exists, but it does not contain a valid private
+			 * key. Abort. */
+			ERROR("Error loading '%s'\n", keys[i].fn);
+			exit(1);
+		}
+
+		/* File does not exist, could not be opened or no filename was
+		 * given */
+		if (new_keys) {
+			/* Try to create a new key */
+			NOTICE("Creating new key for '%s'\n", keys[i].desc);
+			if (!key_create(&keys[i], key_alg, key_size)) {
+				ERROR("Error creating key '%s'\n", keys[i].desc);
+				exit(1);
+			}
+		} else {
+			if (err_code == KEY_ERR_OPEN) {
+				ERROR("Error opening '%s'\n", keys[i].fn);
+			} else {
+				ERROR("Key '%s' not specified\n", keys[i].desc);
+			}
+			exit(1);
+		}
+	}
+}
+
+static void hash_image_job(int idx, void *arg)
+{
+	int ext_idx = ((int *)arg)[idx];
+	const char *image = extensions[ext_idx].arg;
+
+	if (!sha_file_cached(hash_alg, image, image_md[ext_idx])) {
+		ERROR("Cannot calculate hash of %s\n", image);
+		exit(1);
+	}
+}
+
+static bool cert_has_ext(const cert_t *cert, int ext_idx)
+{
+	int i;
+
+	for (i = 0; i < cert->num_ext; i++) {
+		if (cert->ext[i] == ext_idx) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Hash the images of the requested certificates up front, in parallel. Images
+ * already hashed for a previous batch variant are served from the hash cache.
+ */
+static void hash_images(void)
+{
+	int *images;
+	cert_t *cert;
+	ext_t *ext;
+	int i, j, num = 0;
+
+	if (image_md == NULL) {
+		image_md = malloc(num_extensions * sizeof(*image_md));
+	}
+	images = malloc(num_extensions * sizeof(*images));
+	if ((image_md == NULL) || (images == NULL)) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
+	for (i = 0; i < num_extensions; i++) {
+		ext = &extensions[i];
+		if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL)) {
+			continue;
+		}
+		/* Only hash the images of the requested certificates */
+		for (j = 0; j < num_certs; j++) {
+			cert = &certs[j];
+			if ((cert->fn != NULL) && cert_has_ext(cert, i)) {
+				images[num++] = i;
+				break;
+			}
+		}
+	}
+
+	batch_run_jobs(num, num_threads, hash_image_job, images);
+	free(images);
+}
+
+static void create_cert(cert_t *cert)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext = NULL;
+	ext_t *ext;
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->optional && ext->arg == NULL) {
+				/* Skip this NVCounter */
+				continue;
+			} else {
+				/* Checked by `check_cert_params` */
+				assert(ext->arg != NULL);
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA512_DIGEST_LENGTH);
+				} else {
+					/* Do not include this hash in the certificate */
+					continue;
+				}
+			} else {
+				/* Computed by hash_images() */
+				memcpy(md, image_md[cert->ext[j]], md_len);
+			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with corresponding key */
+	if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
+			cert_ext = sk_X509_EXTENSION_pop(sk)) {
+		X509_EXTENSION_free(cert_ext);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+static void create_cert_job(int idx, void *arg)
+{
+	cert_t **wave = arg;
+
+	create_cert(wave[idx]);
+}
+
+/*
+ * Create the requested certificates. A certificate needs its issuer
+ * certificate when that one is created before it, so the certificates are
+ * signed in waves: all the certificates of a wave only depend on the ones of
+ * the previous waves and are signed in parallel.
+ */
+static void create_certs(void)
+{
+	cert_t *cert, **wave;
+	int *depth;
+	int i, j, num, cur, max_depth = 0;
+
+	depth = malloc(num_certs * sizeof(*depth));
+	wave = malloc(num_certs * sizeof(*wave));
+	if ((depth == NULL) || (wave == NULL)) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
+	for (i = 0 ; i < num_certs ; i++) {
+		cert = &certs[i];
+		depth[i] = 0;
+		if ((cert->issuer < i) && (certs[cert->issuer].fn != NULL)) {
+			depth[i] = depth[cert->issuer] + 1;
+		}
+		/*
+		 * A certificate listed before its issuer is created without
+		 * it: keep the issuer out of its wave.
+		 */
+		for (j = 0; j < i; j++) {
+			if ((certs[j].issuer == i) && (certs[j].fn != NULL) &&
+			    (depth[i] <= depth[j])) {
+				depth[i] = depth[j] + 1;
+			}
+		}
+		if (depth[i] > max_depth) {
+			max_depth = depth[i];
+		}
+	}
+
+	for (cur = 0; cur <= max_depth; cur++) {
+		num = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			/* Skip certificates that were not requested */
+			if ((depth[i] == cur) && (certs[i].fn != NULL)) {
+				wave[num++] = &certs[i];
+			}
+		}
+		batch_run_jobs(num, num_threads, create_cert_job, wave);
+	}
+
+	free(wave);
+	free(depth);
+}
+
+static void save_certs(void)
+{
+	FILE *file;
+	int i;
+
+	/* Print the certificates */
+	if (print_cert) {
+		for (i = 0 ; i < num_certs ; i++) {
+			if (!certs[i].x) {
+				continue;
+			}
+			printf("\n\n=====================================\n\n");
+			X509_print_fp(stdout, certs[i].x);
+		}
+	}
+
+	/* Save created certificates to files */
+	for (i = 0 ; i < num_certs ; i++) {
+		if (certs[i].x && certs[i].fn) {
+			file = fopen(certs[i].fn, "w");
+			if (file != NULL) {
+				i2d_X509_fp(file, certs[i].x);
+				fclose(file);
+			} else {
+				ERROR("Cannot create file %s\n", certs[i].fn);
+			}
+		}
+	}
+}
+
+/*
+ * Override the command line image and certificate options with the ones of a
+ * batch variant. Other options (keys, algorithms) are shared by all the
+ * variants.
+ */
+static void apply_variant(const batch_variant_t *variant)
+{
+	const struct option *opt;
+	const batch_opt_t *bopt;
+	ext_t *ext;
+	cert_t *cert;
+	int i;
+
+	for (i = 0; i < variant->num_opts; i++) {
+		bopt = &variant->opts[i];
+		for (opt = cmd_opt_get_array(); opt->name != NULL; opt++) {
+			if (strcmp(opt->name, bopt->name) == 0) {
+				break;
+			}
+		}
+
+		if ((opt->name != NULL) && (opt->val == CMD_OPT_EXT)) {
+			ext = ext_get_by_opt(bopt->name);
+			ext->arg = bopt->arg;
+		} else if ((opt->name != NULL) && (opt->val == CMD_OPT_CERT)) {
+			cert = cert_get_by_opt(bopt->name);
+			cert->fn = bopt->arg;
+		} else {
+			ERROR("Line %d: option '--%s' is not an image or "
+			      "certificate option\n", variant->line, bopt->name);
+			exit(1);
+		}
+	}
+}
+
+static void run_batch(void)
+{
+	batch_variant_t *variants;
+	const char **ext_args, **cert_fns;
+	double start, t_keys, t_hash, t_sign, t_save;
+	unsigned int hits, misses;
+	int i, v, num_variants;
+
+	start = batch_time_ms();
+
+	if (batch_load(batch_file, &variants, &num_variants) != 0) {
+		exit(1);
+	}
+
+	/* Command line values, restored after each variant */
+	ext_args = malloc(num_extensions * sizeof(*ext_args));
+	cert_fns = malloc(num_certs * sizeof(*cert_fns));
+	if ((ext_args == NULL) || (cert_fns == NULL)) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+	for (i = 0; i < num_extensions; i++) {
+		ext_args[i] = extensions[i].arg;
+	}
+	for (i = 0; i < num_certs; i++) {
+		cert_fns[i] = certs[i].fn;
+	}
+
+	/* Check all the variants before doing any work */
+	for (v = 0; v < num_variants; v++) {
+		apply_variant(&variants[v]);
+		check_cert_params();
+		for (i = 0; i < num_extensions; i++) {
+			extensions[i].arg = ext_args[i];
+		}
+		for (i = 0; i < num_certs; i++) {
+			certs[i].fn = cert_fns[i];
+		}
+	}
+
+	/* Keys are shared by all the variants */
+	t_keys = batch_time_ms();
+	load_keys();
+	t_keys = batch_time_ms() - t_keys;
+	NOTICE("Loaded keys in %.3f ms\n", t_keys);
+
+	for (v = 0; v < num_variants; v++) {
+		apply_variant(&variants[v]);
+
+		t_hash = batch_time_ms();
+		hash_images();
+		t_sign = batch_time_ms();
+		create_certs();
+		t_save = batch_time_ms();
+		save_certs();
+		NOTICE("Variant %d (line %d): hash %.3f ms, sign %.3f ms, "
+		       "write %.3f ms\n", v + 1, variants[v].line,
+		       t_sign - t_hash, t_save - t_sign,
+		       batch_time_ms() - t_save);
+
+		for (i = 0; i < num_certs; i++) {
+			X509_free(certs[i].x);
+			certs[i].x = NULL;
+			certs[i].fn = cert_fns[i];
+		}
+		for (i = 0; i < num_extensions; i++) {
+			extensions[i].arg = ext_args[i];
+		}
+	}
+
+	sha_cache_stats(&hits, &misses);
+	NOTICE("Generated %d variants in %.3f ms (%u images hashed, "
+	       "%u hashes reused)\n", num_variants, batch_time_ms() - start,
+	       misses, hits);
+
+	free(cert_fns);
+	free(ext_args);
+	batch_free(variants, num_variants);
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
-	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -347,7 +784,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:B:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -369,9 +806,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'B':
+			batch_file = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			num_threads = get_num_threads(optarg);
+			if (num_threads < 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -415,6 +862,11 @@ int main(int argc, char *argv[])
 		key_size = KEY_SIZES[key_alg][0];
 	}
 
+	/* Use all the CPUs unless told otherwise */
+	if (num_threads == 0) {
+		num_threads = batch_num_cpus();
+	}
+
 	/* Check command line arguments */
 	check_cmd_params();
 
@@ -431,161 +883,13 @@ int main(int argc, char *argv[])
 		md_len  = SHA256_DIGEST_LENGTH;
 	}
 
-	/* Load private keys from files (or generate new ones) */
-	for (i = 0 ; i < num_keys ; i++) {
-#if !USING_OPENSSL3
-		if (!key_new(&keys[i])) {
-			ERROR("Failed to allocate key container\n");
-			exit(1);
-		}
-#endif
-
-		/* First try to load the key from disk */
-		err_code = key_load(&keys[i]);
-		if (err_code == KEY_ERR_NONE) {
-			/* Key loaded successfully */
-			continue;
-		}
-
-		/* Key not loaded. Check the error code */
-		if (err_code == KEY_ERR_LOAD) {
-			/* File exists, but it does not contain a valid private
-			 * key. Abort. */
-			ERROR("Error loading '%s'\n", keys[i].fn);
-			exit(1);
-		}
-
-		/* File does not exist, could not be opened or no filename was
-		 * given */
-		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg, key_size)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
-		} else {
-			if (err_code == KEY_ERR_OPEN) {
-				ERROR("Error opening '%s'\n", keys[i].fn);
-			} else {
-				ERROR("Key '%s' not specified\n", keys[i].desc);
-			}
-			exit(1);
-		}
-	}
-
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
-			continue;
-		}
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
-				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
-
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
-
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
-		}
-
-		sk_X509_EXTENSION_free(sk);
-	}
-
-
-	/* Print the certificates */
-	if (print_cert) {
-		for (i = 0 ; i < num_certs ; i++) {
-			if (!certs[i].x) {
-				continue;
-			}
-			printf("\n\n=====================================\n\n");
-			X509_print_fp(stdout, certs[i].x);
-		}
-	}
-
-	/* Save created certificates to files */
-	for (i = 0 ; i < num_certs ; i++) {
-		if (certs[i].x && certs[i].fn) {
-			file = fopen(certs[i].fn, "w");
-			if (file != NULL) {
-				i2d_X509_fp(file, certs[i].x);
-				fclose(file);
-			} else {
-				ERROR("Cannot create file %s\n", certs[i].fn);
-			}
-		}
+	if (batch_file != NULL) {
+		run_batch();
+	} else {
+		load_keys();
+		hash_images();
+		create_certs();
+		save_certs();
 	}
 
 	/* Save keys */
@@ -614,5 +918,8 @@ int main(int argc, char *argv[])
 
 	cert_cleanup();
 
+	sha_cache_cleanup();
+	free(image_md);
+
 	return 0;
 }
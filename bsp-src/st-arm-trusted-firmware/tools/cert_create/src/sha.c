@@ -4,9 +4,18 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* stat() and the pthread API are not part of C99 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 #include "debug.h"
 #include "key.h"
+#include "sha.h"
 #if USING_OPENSSL3
 #include <openssl/evp.h>
 #include <openssl/obj_mac.h>
@@ -15,6 +24,28 @@
 #endif
 
 #define BUFFER_SIZE	256
+#define MAX_MD_LEN	64
+
+/*
+ * Image hashes already computed, indexed by file identity. An entry is only
+ * reused if the file size and modification time did not change, so files
+ * shared by several batch variants (or given twice) are only hashed once.
+ */
+typedef struct sha_cache_s sha_cache_t;
+struct sha_cache_s {
+	sha_cache_t *next;
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	struct timespec mtime;
+	int md_alg;
+	unsigned char md[MAX_MD_LEN];
+};
+
+static sha_cache_t *sha_cache;
+static pthread_mutex_t sha_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int sha_cache_hits;
+static unsigned int sha_cache_misses;
 
 #if USING_OPENSSL3
 static int get_algorithm_nid(int hash_alg)
@@ -116,3 +147,106 @@ err:
 #endif
 }
 
+static unsigned int sha_len(int md_alg)
+{
+	if (md_alg == HASH_ALG_SHA384) {
+		return 48;
+	} else if (md_alg == HASH_ALG_SHA512) {
+		return 64;
+	}
+
+	return 32;
+}
+
+static sha_cache_t *sha_cache_find(int md_alg, const struct stat *st)
+{
+	sha_cache_t *entry;
+
+	for (entry = sha_cache; entry != NULL; entry = entry->next) {
+		if ((entry->md_alg == md_alg) &&
+		    (entry->dev == st->st_dev) &&
+		    (entry->ino == st->st_ino) &&
+		    (entry->size == st->st_size) &&
+		    (entry->mtime.tv_sec == st->st_mtim.tv_sec) &&
+		    (entry->mtime.tv_nsec == st->st_mtim.tv_nsec)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Same as sha_file(), but reuse the hash of a file that was already hashed.
+ * This function may be called from several threads.
+ */
+int sha_file_cached(int md_alg, const char *filename, unsigned char *md)
+{
+	struct stat st;
+	sha_cache_t *entry;
+	unsigned int len = sha_len(md_alg);
+
+	if ((filename == NULL) || (md == NULL)) {
+		ERROR("%s(): NULL argument\n", __func__);
+		return 0;
+	}
+
+	/* Let sha_file() report files that cannot be accessed */
+	if (stat(filename, &st) != 0) {
+		return sha_file(md_alg, filename, md);
+	}
+
+	pthread_mutex_lock(&sha_cache_lock);
+	entry = sha_cache_find(md_alg, &st);
+	if (entry != NULL) {
+		memcpy(md, entry->md, len);
+		sha_cache_hits++;
+	}
+	pthread_mutex_unlock(&sha_cache_lock);
+	if (entry != NULL) {
+		return 1;
+	}
+
+	if (!sha_file(md_alg, filename, md)) {
+		return 0;
+	}
+
+	entry = malloc(sizeof(*entry));
+	if (entry == NULL) {
+		/* The hash is valid, it is just not cached */
+		return 1;
+	}
+	entry->dev = st.st_dev;
+	entry->ino = st.st_ino;
+	entry->size = st.st_size;
+	entry->mtime = st.st_mtim;
+	entry->md_alg = md_alg;
+	memcpy(entry->md, md, len);
+
+	pthread_mutex_lock(&sha_cache_lock);
+	entry->next = sha_cache;
+	sha_cache = entry;
+	sha_cache_misses++;
+	pthread_mutex_unlock(&sha_cache_lock);
+
+	return 1;
+}
+
+void sha_cache_stats(unsigned int *hits, unsigned int *misses)
+{
+	pthread_mutex_lock(&sha_cache_lock);
+	*hits = sha_cache_hits;
+	*misses = sha_cache_misses;
+	pthread_mutex_unlock(&sha_cache_lock);
+}
+
+void sha_cache_cleanup(void)
+{
+	sha_cache_t *entry;
+
+	while (sha_cache != NULL) {
+		entry = sha_cache;
+		sha_cache = entry->next;
+		free(entry);
+	}
+}
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "fiptool.h"
 #include "tbbr_config.h"
@@ -56,6 +57,10 @@ static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
+static long nr_jobs = 1;
+static char *fip_buf;
+
+typedef void (*job_fn_t)(size_t idx, void *arg);
 
 static void vlog(int prio, const char *msg, va_list ap)
 {
@@ -137,6 +142,106 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+static double time_ms(void)
+{
+#ifndef _MSC_VER
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#else
+	return clock() * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+#ifndef _MSC_VER
+typedef struct job_queue {
+	pthread_mutex_t lock;
+	size_t          next;
+	size_t          nr;
+	job_fn_t        fn;
+	void           *arg;
+} job_queue_t;
+
+static void *job_worker(void *data)
+{
+	job_queue_t *queue = data;
+	size_t idx;
+
+	while (1) {
+		pthread_mutex_lock(&queue->lock);
+		idx = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+		if (idx >= queue->nr)
+			break;
+		queue->fn(idx, queue->arg);
+	}
+	return NULL;
+}
+#endif
+
+/*
+ * Call fn() for each index in [0, nr), using up to nr_jobs threads.
+ * The jobs must be independent from each other.
+ */
+static void run_jobs(size_t nr, job_fn_t fn, void *arg)
+{
+	size_t i;
+#ifndef _MSC_VER
+	size_t nr_threads = (size_t)nr_jobs < nr ? (size_t)nr_jobs : nr;
+
+	if (nr_threads > 1) {
+		job_queue_t queue;
+		pthread_t *threads;
+
+		queue.next = 0;
+		queue.nr = nr;
+		queue.fn = fn;
+		queue.arg = arg;
+		if (pthread_mutex_init(&queue.lock, NULL) != 0)
+			log_errx("Failed to initialize job queue");
+
+		threads = xmalloc(nr_threads * sizeof(*threads),
+		    "failed to allocate worker threads");
+		/* The calling thread is the first worker. */
+		for (i = 1; i < nr_threads; i++)
+			if (pthread_create(&threads[i], NULL, job_worker,
+			    &queue) != 0)
+				log_errx("Failed to create worker thread");
+		job_worker(&queue);
+		for (i = 1; i < nr_threads; i++)
+			pthread_join(threads[i], NULL);
+
+		pthread_mutex_destroy(&queue.lock);
+		free(threads);
+		return;
+	}
+#endif
+	for (i = 0; i < nr; i++)
+		fn(i, arg);
+}
+
+static void free_image(image_t *image)
+{
+	if (image == NULL)
+		return;
+
+	switch (image->buffer_type) {
+#ifndef _MSC_VER
+	case IMAGE_BUF_MMAP:
+		munmap(image->buffer, image->toc_e.size);
+		break;
+#endif
+	case IMAGE_BUF_FIP:
+		/* Points into fip_buf, released with the descriptors. */
+		break;
+	default:
+		free(image->buffer);
+		break;
+	}
+	free(image);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -172,10 +277,7 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	free_image(desc->image);
 	free(desc);
 }
 
@@ -202,6 +304,9 @@ static void free_image_descs(void)
 		nr_image_descs--;
 	}
 	assert(nr_image_descs == 0);
+
+	free(fip_buf);
+	fip_buf = NULL;
 }
 
 static void fill_image_descs(void)
@@ -355,9 +460,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
 		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
+		/* Overflow checks before referencing the image data. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted: entry size exceeds 64 bit address space",
 				filename);
@@ -365,8 +468,9 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 			log_errx("FIP %s is corrupted: entry size exceeds FIP file size",
 				filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		/* The image data is used in place from the FIP buffer. */
+		image->buffer = buf + toc_entry->offset_address;
+		image->buffer_type = IMAGE_BUF_FIP;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -392,7 +496,9 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+
+	assert(fip_buf == NULL);
+	fip_buf = buf;
 	return 0;
 }
 
@@ -414,10 +520,26 @@ static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
+	image->toc_e.size = st.st_size;
+
+#ifndef _MSC_VER
+	/* Input images are only read, map them instead of copying them. */
+	if (S_ISREG(st.st_mode) && st.st_size > 0) {
+		image->buffer = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+		    fileno(fp), 0);
+		if (image->buffer != MAP_FAILED) {
+			posix_madvise(image->buffer, st.st_size,
+			    POSIX_MADV_WILLNEED);
+			image->buffer_type = IMAGE_BUF_MMAP;
+			fclose(fp);
+			return image;
+		}
+	}
+#endif
+
 	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
 	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
 		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
 
 	fclose(fp);
 	return image;
@@ -470,10 +592,29 @@ static void md_print(const unsigned char *md, size_t len)
 }
 #endif
 
+#if !defined(_MSC_VER) && !STATIC
+typedef struct hash_job {
+	const image_t *image;
+	unsigned char  md[SHA256_DIGEST_LENGTH];
+} hash_job_t;
+
+static void hash_image_job(size_t idx, void *arg)
+{
+	hash_job_t *job = (hash_job_t *)arg + idx;
+
+	SHA256(job->image->buffer, job->image->toc_e.size, job->md);
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#if !defined(_MSC_VER) && !STATIC
+	hash_job_t *jobs = NULL;
+	size_t nr = 0;
+	double start;
+#endif
 
 	if (argc != 2)
 		info_usage(EXIT_FAILURE);
@@ -490,6 +631,22 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#if !defined(_MSC_VER) && !STATIC
+	/* Hash all the images up front, as they are independent. */
+	if (verbose) {
+		start = time_ms();
+		jobs = xzalloc(nr_image_descs * sizeof(*jobs),
+		    "failed to allocate hash jobs");
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				jobs[nr++].image = desc->image;
+		run_jobs(nr, hash_image_job, jobs);
+		log_dbgx("Hashed %zu images in %.3f ms", nr,
+		    time_ms() - start);
+		nr = 0;
+	}
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -508,16 +665,16 @@ static int info_cmd(int argc, char *argv[])
 		 */
 #if !defined(_MSC_VER) && !STATIC
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(jobs[nr++].md, SHA256_DIGEST_LENGTH);
 		}
 #endif
 		putchar('\n');
 	}
 
+#if !defined(_MSC_VER) && !STATIC
+	free(jobs);
+#endif
 	return 0;
 }
 
@@ -527,15 +684,125 @@ static void info_usage(int exit_status)
 	exit(exit_status);
 }
 
-static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+/* Part of the FIP file to write, in order. */
+typedef struct fip_chunk {
+	const void *buf;
+	size_t      size;
+} fip_chunk_t;
+
+#ifndef _MSC_VER
+/*
+ * Input images are mapped: if one of them is the output file, copy it before
+ * the output file is truncated.
+ */
+static void unmap_output_images(const char *filename)
+{
+	struct BLD_PLAT_STAT out_st, in_st;
+	image_desc_t *desc;
+
+	if (stat(filename, &out_st) == -1)
+		return;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+		void *buf;
+
+		if (image == NULL || image->buffer_type != IMAGE_BUF_MMAP ||
+		    desc->action_arg == NULL ||
+		    stat(desc->action_arg, &in_st) == -1)
+			continue;
+
+		if (in_st.st_dev != out_st.st_dev ||
+		    in_st.st_ino != out_st.st_ino)
+			continue;
+
+		buf = xmalloc(image->toc_e.size,
+		    "failed to allocate image buffer");
+		memcpy(buf, image->buffer, image->toc_e.size);
+		munmap(image->buffer, image->toc_e.size);
+		image->buffer = buf;
+		image->buffer_type = IMAGE_BUF_MALLOC;
+	}
+}
+
+/* Write all the chunks with as few system calls as possible. */
+static void write_chunks(const char *filename, const fip_chunk_t *chunks,
+    size_t nr_chunks)
+{
+	struct iovec *iov;
+	size_t i, first = 0;
+	int fd;
+
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1)
+		log_err("open %s", filename);
+
+	iov = xmalloc(nr_chunks * sizeof(*iov), "failed to allocate iovec");
+	for (i = 0; i < nr_chunks; i++) {
+		iov[i].iov_base = (void *)chunks[i].buf;
+		iov[i].iov_len = chunks[i].size;
+	}
+
+	while (first < nr_chunks) {
+		int cnt = nr_chunks - first > IOV_MAX ?
+		    IOV_MAX : (int)(nr_chunks - first);
+		ssize_t ret = writev(fd, &iov[first], cnt);
+		size_t done;
+
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("Failed to write %s", filename);
+		}
+
+		/* Skip what was written, resume after a short write. */
+		done = ret;
+		while (first < nr_chunks && done >= iov[first].iov_len) {
+			done -= iov[first].iov_len;
+			first++;
+		}
+		if (done != 0) {
+			iov[first].iov_base = (char *)iov[first].iov_base + done;
+			iov[first].iov_len -= done;
+		}
+	}
+
+	if (close(fd) == -1)
+		log_err("Failed to write %s", filename);
+	free(iov);
+}
+#else
+static void write_chunks(const char *filename, const fip_chunk_t *chunks,
+    size_t nr_chunks)
 {
 	FILE *fp;
+	size_t i;
+
+	fp = fopen(filename, "wb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	for (i = 0; i < nr_chunks; i++)
+		xfwrite((void *)chunks[i].buf, chunks[i].size, fp, filename);
+
+	fclose(fp);
+}
+#endif
+
+static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
+{
 	image_desc_t *desc;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
-	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
-	size_t nr_images = 0;
+	fip_chunk_t *chunks;
+	char *buf, *pad;
+	uint64_t entry_offset, buf_size, payload_size = 0;
+	size_t nr_images = 0, nr_chunks = 0;
+	double start;
+
+#ifndef _MSC_VER
+	unmap_output_images(filename);
+#endif
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
 		if (desc->image != NULL)
@@ -547,6 +814,13 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	if (buf == NULL)
 		log_err("calloc");
 
+	/* At most one padding and one image chunk per image, plus the end. */
+	chunks = xmalloc((2 * nr_images + 2) * sizeof(*chunks),
+	    "failed to allocate FIP chunks");
+	pad = calloc(1, align);
+	if (pad == NULL)
+		log_err("calloc");
+
 	/* Build up header and ToC entries from the image table. */
 	toc_header = (fip_toc_header_t *)buf;
 	toc_header->name = TOC_HEADER_NAME;
@@ -555,17 +829,27 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 
 	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
 
+	chunks[nr_chunks].buf = buf;
+	chunks[nr_chunks++].size = buf_size;
+
 	entry_offset = buf_size;
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
+		uint64_t aligned_offset;
 
 		if (image == NULL || (image->toc_e.size == 0ULL))
 			continue;
 		payload_size += image->toc_e.size;
-		entry_offset = (entry_offset + align - 1) & ~(align - 1);
-		image->toc_e.offset_address = entry_offset;
+		aligned_offset = (entry_offset + align - 1) & ~(align - 1);
+		if (aligned_offset != entry_offset) {
+			chunks[nr_chunks].buf = pad;
+			chunks[nr_chunks++].size = aligned_offset - entry_offset;
+		}
+		image->toc_e.offset_address = aligned_offset;
 		*toc_entry++ = image->toc_e;
-		entry_offset += image->toc_e.size;
+		chunks[nr_chunks].buf = image->buffer;
+		chunks[nr_chunks++].size = image->toc_e.size;
+		entry_offset = aligned_offset + image->toc_e.size;
 	}
 
 	/*
@@ -575,40 +859,26 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	 */
 	memset(toc_entry, 0, sizeof(*toc_entry));
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
+	if (toc_entry->offset_address != entry_offset) {
+		chunks[nr_chunks].buf = pad;
+		chunks[nr_chunks++].size = toc_entry->offset_address -
+		    entry_offset;
+	}
 
-	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (verbose)
+	if (verbose) {
 		log_dbgx("Metadata size: %zu bytes", buf_size);
-
-	xfwrite(buf, buf_size, fp, filename);
-
-	if (verbose)
 		log_dbgx("Payload size: %zu bytes", payload_size);
-
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image = desc->image;
-
-		if (image == NULL)
-			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
-
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
 	}
 
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
-
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	/* Generate the FIP file. */
+	start = time_ms();
+	write_chunks(filename, chunks, nr_chunks);
+	if (verbose)
+		log_dbgx("Wrote %s in %.3f ms", filename, time_ms() - start);
 
+	free(pad);
+	free(chunks);
 	free(buf);
-	fclose(fp);
 	return 0;
 }
 
@@ -619,34 +889,64 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
  * in update_fip() creating the new FIP file from scratch because the
  * internal image table is not populated.
  */
+typedef struct load_job {
+	image_desc_t *desc;
+	image_t      *image;
+} load_job_t;
+
+static void load_image_job(size_t idx, void *arg)
+{
+	load_job_t *job = (load_job_t *)arg + idx;
+
+	job->image = read_image_from_file(&job->desc->uuid,
+	    job->desc->action_arg);
+}
+
 static void update_fip(void)
 {
 	image_desc_t *desc;
+	load_job_t *jobs;
+	size_t nr = 0, i;
+	double start;
 
-	/* Add or replace images in the FIP file. */
-	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
-		image_t *image;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->action == DO_PACK)
+			nr++;
+	if (nr == 0)
+		return;
 
-		if (desc->action != DO_PACK)
-			continue;
+	jobs = xmalloc(nr * sizeof(*jobs), "failed to allocate load jobs");
+	nr = 0;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->action == DO_PACK)
+			jobs[nr++].desc = desc;
 
-		image = read_image_from_file(&desc->uuid,
-		    desc->action_arg);
+	/* Read the input images in parallel. */
+	start = time_ms();
+	run_jobs(nr, load_image_job, jobs);
+	if (verbose)
+		log_dbgx("Loaded %zu images in %.3f ms", nr,
+		    time_ms() - start);
+
+	/* Add or replace images in the FIP file. */
+	for (i = 0; i < nr; i++) {
+		desc = jobs[i].desc;
 		if (desc->image != NULL) {
 			if (verbose) {
 				log_dbgx("Replacing %s with %s",
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
-			desc->image = image;
+			free_image(desc->image);
+			desc->image = jobs[i].image;
 		} else {
 			if (verbose)
 				log_dbgx("Adding image %s",
 				    desc->action_arg);
-			desc->image = image;
+			desc->image = jobs[i].image;
 		}
 	}
+	free(jobs);
 }
 
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
@@ -916,12 +1216,27 @@ static void update_usage(int exit_status)
 	exit(exit_status);
 }
 
+typedef struct unpack_job {
+	image_t *image;
+	char    *file;
+} unpack_job_t;
+
+static void unpack_image_job(size_t idx, void *arg)
+{
+	unpack_job_t *job = (unpack_job_t *)arg + idx;
+
+	write_image_to_file(job->image, job->file);
+}
+
 static int unpack_cmd(int argc, char *argv[])
 {
 	struct option *opts = NULL;
 	size_t nr_opts = 0;
 	char outdir[PATH_MAX] = { 0 };
 	image_desc_t *desc;
+	unpack_job_t *jobs;
+	size_t nr = 0, i;
+	double start;
 	int fflag = 0;
 	int unpack_all = 1;
 
@@ -996,7 +1311,12 @@ static int unpack_cmd(int argc, char *argv[])
 		if (chdir(outdir) == -1)
 			log_err("chdir %s", outdir);
 
-	/* Unpack all specified images. */
+	/* Select the images to unpack, in order. */
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		nr++;
+	jobs = xmalloc(nr * sizeof(*jobs), "failed to allocate unpack jobs");
+	nr = 0;
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		char file[PATH_MAX];
 		image_t *image = desc->image;
@@ -1022,13 +1342,27 @@ static int unpack_cmd(int argc, char *argv[])
 		if (access(file, F_OK) != 0 || fflag) {
 			if (verbose)
 				log_dbgx("Unpacking %s", file);
-			write_image_to_file(image, file);
+			jobs[nr].image = image;
+			jobs[nr].file = xstrdup(file,
+			    "failed to allocate memory for filename");
+			nr++;
 		} else {
 			log_warnx("File %s already exists, use --force to overwrite it",
 			    file);
 		}
 	}
 
+	/* Unpack all specified images. */
+	start = time_ms();
+	run_jobs(nr, unpack_image_job, jobs);
+	if (verbose)
+		log_dbgx("Unpacked %zu images in %.3f ms", nr,
+		    time_ms() - start);
+
+	for (i = 0; i < nr; i++)
+		free(jobs[i].file);
+	free(jobs);
+
 	return 0;
 }
 
@@ -1150,7 +1484,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1224,8 +1558,9 @@ static int help_cmd(int argc, char *argv[])
 
 static void usage(void)
 {
-	printf("usage: fiptool [--verbose] <command> [<args>]\n");
+	printf("usage: fiptool [--verbose] [--jobs N] <command> [<args>]\n");
 	printf("Global options supported:\n");
+	printf("  --jobs N\tUse N threads to read, hash and write images (0: one per CPU).\n");
 	printf("  --verbose\tEnable verbose output for all commands.\n");
 	printf("\n");
 	printf("Commands supported:\n");
@@ -1239,6 +1574,24 @@ static void usage(void)
 	exit(EXIT_SUCCESS);
 }
 
+static void parse_jobs(const char *arg)
+{
+	char *endptr;
+
+	errno = 0;
+	nr_jobs = strtol(arg, &endptr, 0);
+	if (*endptr != '\0' || nr_jobs < 0 || errno != 0)
+		log_errx("Invalid number of jobs: %s", arg);
+
+	if (nr_jobs == 0) {
+#ifndef _MSC_VER
+		nr_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		if (nr_jobs < 1)
+			nr_jobs = 1;
+	}
+}
+
 int main(int argc, char *argv[])
 {
 	int i, ret = 0;
@@ -1246,6 +1599,7 @@ int main(int argc, char *argv[])
 	while (1) {
 		int c, opt_index = 0;
 		static struct option opts[] = {
+			{ "jobs", required_argument, NULL, 'j' },
 			{ "verbose", no_argument, NULL, 'v' },
 			{ NULL, no_argument, NULL, 0 }
 		};
@@ -1254,11 +1608,14 @@ int main(int argc, char *argv[])
 		 * Set POSIX mode so getopt stops at the first non-option
 		 * which is the subcommand.
 		 */
-		c = getopt_long(argc, argv, "+v", opts, &opt_index);
+		c = getopt_long(argc, argv, "+j:v", opts, &opt_index);
 		if (c == -1)
 			break;
 
 		switch (c) {
+		case 'j':
+			parse_jobs(optarg);
+			break;
 		case 'v':
 			verbose = 1;
 			break;
@@ -40,9 +40,16 @@ typedef struct image_desc {
 	struct image_desc *next;
 } image_desc_t;
 
+enum {
+	IMAGE_BUF_MALLOC = 0,
+	IMAGE_BUF_MMAP   = 1,
+	IMAGE_BUF_FIP    = 2
+};
+
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	int                  buffer_type;
 } image_t;
 
 typedef struct cmd {
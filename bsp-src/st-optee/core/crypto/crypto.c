@@ -477,6 +477,74 @@ void crypto_authenc_copy_state(void *dst_ctx, void *src_ctx)
 	ae_ops(dst_ctx)->copy_state(dst_ctx, src_ctx);
 }
 
+static TEE_Result authenc_do_job(void *ctx, struct crypto_authenc_job *job)
+{
+	TEE_Result res = TEE_ERROR_GENERIC;
+	size_t dst_len = job->len;
+	size_t tag_len = job->tag_len;
+
+	res = crypto_authenc_init(ctx, job->mode, job->key, job->key_len,
+				  job->nonce, job->nonce_len, job->tag_len,
+				  job->aad_len, job->len);
+	if (res)
+		return res;
+
+	if (job->aad_len) {
+		res = crypto_authenc_update_aad(ctx, job->mode, job->aad,
+						job->aad_len);
+		if (res)
+			goto out;
+	}
+
+	if (job->mode == TEE_MODE_ENCRYPT) {
+		res = crypto_authenc_enc_final(ctx, job->src, job->len,
+					       job->dst, &dst_len, job->tag,
+					       &tag_len);
+		if (!res && tag_len != job->tag_len)
+			res = TEE_ERROR_GENERIC;
+	} else {
+		res = crypto_authenc_dec_final(ctx, job->src, job->len,
+					       job->dst, &dst_len, job->tag,
+					       job->tag_len);
+	}
+
+out:
+	crypto_authenc_final(ctx);
+
+	return res;
+}
+
+TEE_Result crypto_authenc_batch(uint32_t algo, struct crypto_authenc_job *jobs,
+				size_t count)
+{
+	TEE_Result res = TEE_ERROR_NOT_IMPLEMENTED;
+	void *ctx = NULL;
+	size_t n = 0;
+
+	if (!jobs && count)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = drvcrypt_authenc_batch(algo, jobs, count);
+	if (res != TEE_ERROR_NOT_IMPLEMENTED)
+		return res;
+
+	/* No driver batch support, process the jobs one after the other */
+	res = crypto_authenc_alloc_ctx(&ctx, algo);
+	if (res)
+		return res;
+
+	res = TEE_SUCCESS;
+	for (n = 0; n < count; n++) {
+		jobs[n].res = authenc_do_job(ctx, jobs + n);
+		if (jobs[n].res && !res)
+			res = jobs[n].res;
+	}
+
+	crypto_authenc_free_ctx(ctx);
+
+	return res;
+}
+
 #if !defined(CFG_CRYPTO_RSA) && !defined(CFG_CRYPTO_DSA) && \
     !defined(CFG_CRYPTO_DH) && !defined(CFG_CRYPTO_ECC)
 struct bignum *crypto_bignum_allocate(size_t size_bits __unused)
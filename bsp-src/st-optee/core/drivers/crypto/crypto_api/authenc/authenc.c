@@ -302,6 +302,20 @@ static const struct crypto_authenc_ops authenc_ops = {
 	.copy_state = authenc_copy_state,
 };
 
+TEE_Result drvcrypt_authenc_batch(uint32_t algo,
+				  struct crypto_authenc_job *jobs,
+				  size_t count)
+{
+	TEE_Result ret = TEE_ERROR_NOT_IMPLEMENTED;
+	struct drvcrypt_authenc *op = drvcrypt_get_ops(CRYPTO_AUTHENC);
+
+	if (op && op->batch)
+		ret = op->batch(algo, jobs, count);
+
+	CRYPTO_TRACE("authenc batch of %zu ret 0x%" PRIx32, count, ret);
+	return ret;
+}
+
 TEE_Result drvcrypt_authenc_alloc_ctx(struct crypto_authenc_ctx **ctx,
 				      uint32_t algo)
 {
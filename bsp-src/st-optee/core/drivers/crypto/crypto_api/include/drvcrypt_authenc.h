@@ -84,6 +84,9 @@ struct drvcrypt_authenc {
 	void (*final)(void *ctx);
 	/* Copy authenc context */
 	void (*copy_state)(void *dst_ctx, void *src_ctx);
+	/* Process a batch of single-shot operations (optional) */
+	TEE_Result (*batch)(uint32_t algo, struct crypto_authenc_job *jobs,
+			    size_t count);
 };
 
 /*
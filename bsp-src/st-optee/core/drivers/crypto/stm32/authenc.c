@@ -11,6 +11,7 @@
 #include <drvcrypt_authenc.h>
 #include <initcall.h>
 #include <stdlib.h>
+#include <stdlib_ext.h>
 #include <string.h>
 #include <string_ext.h>
 #include <tee_api_types.h>
@@ -44,7 +45,7 @@ static struct stm32_ae_ctx *to_stm32_ae_ctx(struct crypto_authenc_ctx *ctx)
 	return container_of(ctx, struct stm32_ae_ctx, a_ctx);
 }
 
-static TEE_Result stm32_ae_gcm_generate_iv(struct stm32_ae_ctx *c,
+static TEE_Result stm32_ae_gcm_generate_iv(uint8_t *tag_mask,
 					   uint32_t *iv,
 					   struct drvcrypt_authenc_init *dinit)
 {
@@ -57,6 +58,8 @@ static TEE_Result stm32_ae_gcm_generate_iv(struct stm32_ae_ctx *c,
 	uint8_t *data_out = NULL;
 
 	if (dinit->nonce.length == 12) {
+		/* Hardware J0 is the expected one, no tag correction */
+		memset(tag_mask, 0, MAX_TAG_SIZE);
 		memcpy(iv, dinit->nonce.data, dinit->nonce.length);
 		iv[3] = TEE_U32_TO_BIG_ENDIAN(2);
 		return TEE_SUCCESS;
@@ -133,7 +136,7 @@ static TEE_Result stm32_ae_gcm_generate_iv(struct stm32_ae_ctx *c,
 	 * Save the mask we will apply in {enc,dec}_final() to the
 	 * (wrongly) computed tag to get the expected one.
 	 */
-	xor_vec(c->tag_mask, tag1, tag2, sizeof(c->tag_mask));
+	xor_vec(tag_mask, tag1, tag2, MAX_TAG_SIZE);
 
 	return TEE_SUCCESS;
 }
@@ -211,7 +214,7 @@ static TEE_Result stm32_ae_initialize(struct drvcrypt_authenc_init *dinit)
 	struct stm32_ae_ctx *c = to_stm32_ae_ctx(dinit->ctx);
 
 	if (c->algo == STM32_CRYP_MODE_AES_GCM) {
-		res = stm32_ae_gcm_generate_iv(c, iv, dinit);
+		res = stm32_ae_gcm_generate_iv(c->tag_mask, iv, dinit);
 		if (res)
 			return res;
 	} else if (c->algo == STM32_CRYP_MODE_AES_CCM) {
@@ -319,6 +322,144 @@ static void stm32_ae_copy_state(void *dst_ctx, void *src_ctx)
 	memcpy(dst, src, sizeof(*dst));
 }
 
+/*
+ * Number of GCM operations prepared and submitted at once to the CRYP
+ * by stm32_ae_batch()
+ */
+#define STM32_AE_BATCH_MAX		8U
+
+struct stm32_ae_batch {
+	struct stm32_cryp_gcm_job gcm[STM32_AE_BATCH_MAX];
+	struct stm32_cryp_context cryp[STM32_AE_BATCH_MAX];
+	uint8_t tag_mask[STM32_AE_BATCH_MAX][MAX_TAG_SIZE];
+	struct crypto_authenc_job *job[STM32_AE_BATCH_MAX];
+};
+
+static TEE_Result stm32_ae_batch_prepare(struct stm32_ae_batch *b, size_t idx,
+					 struct crypto_authenc_job *job)
+{
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t iv[4] = { 0 };
+	struct drvcrypt_authenc_init dinit = {
+		.encrypt = job->mode == TEE_MODE_ENCRYPT,
+		.key.data = (uint8_t *)job->key,
+		.key.length = job->key_len,
+		.nonce.data = (uint8_t *)job->nonce,
+		.nonce.length = job->nonce_len,
+		.tag_len = job->tag_len,
+		.aad_len = job->aad_len,
+		.payload_len = job->len,
+	};
+
+	if (!job->tag_len || job->tag_len > MAX_TAG_SIZE || !job->tag ||
+	    !job->key || !job->nonce || !job->nonce_len ||
+	    (job->aad_len && !job->aad) ||
+	    (job->len && (!job->src || !job->dst)))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = stm32_ae_gcm_generate_iv(b->tag_mask[idx], iv, &dinit);
+	if (res)
+		return res;
+
+	res = stm32_cryp_init(&b->cryp[idx], !dinit.encrypt,
+			      STM32_CRYP_MODE_AES_GCM, job->key, job->key_len,
+			      iv, sizeof(iv));
+	if (res)
+		return res;
+
+	b->gcm[idx] = (struct stm32_cryp_gcm_job){
+		.ctx = &b->cryp[idx],
+		.aad = (uint8_t *)job->aad,
+		.aad_size = job->aad_len,
+		.data_in = (uint8_t *)job->src,
+		.data_out = job->dst,
+		.data_size = job->len,
+	};
+	b->job[idx] = job;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result stm32_ae_batch_complete(struct stm32_ae_batch *b,
+					  size_t idx)
+{
+	struct crypto_authenc_job *job = b->job[idx];
+	uint8_t tag[MAX_TAG_SIZE] = { 0 };
+
+	if (b->gcm[idx].res)
+		return b->gcm[idx].res;
+
+	xor_vec(tag, b->gcm[idx].tag, b->tag_mask[idx], job->tag_len);
+
+	if (job->mode == TEE_MODE_ENCRYPT) {
+		memcpy(job->tag, tag, job->tag_len);
+		return TEE_SUCCESS;
+	}
+
+	if (consttime_memcmp(tag, job->tag, job->tag_len)) {
+		/* Don't release the payload of a non authentic message */
+		memzero_explicit(job->dst, job->len);
+		return TEE_ERROR_MAC_INVALID;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Process a batch of single-shot AES GCM operations. Jobs are prepared
+ * by groups of STM32_AE_BATCH_MAX and each group is processed by the CRYP
+ * in a single hardware session. Other algorithms are left to the generic
+ * crypto_authenc_batch() fallback.
+ */
+static TEE_Result stm32_ae_batch(uint32_t algo, struct crypto_authenc_job *jobs,
+				 size_t count)
+{
+	TEE_Result res = TEE_SUCCESS;
+	struct stm32_ae_batch *b = NULL;
+	size_t nb_ready = 0;
+	size_t idx = 0;
+	size_t n = 0;
+	size_t i = 0;
+
+	if (algo != TEE_ALG_AES_GCM)
+		return TEE_ERROR_NOT_IMPLEMENTED;
+
+	if (!count)
+		return TEE_SUCCESS;
+
+	b = calloc(1, sizeof(*b));
+	if (!b)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	for (n = 0; n < count; n += i) {
+		nb_ready = 0;
+
+		for (i = 0; i < STM32_AE_BATCH_MAX && n + i < count; i++) {
+			jobs[n + i].res = stm32_ae_batch_prepare(b, nb_ready,
+								 jobs + n + i);
+			if (!jobs[n + i].res)
+				nb_ready++;
+		}
+
+		/* Job results are reported through b->gcm[].res */
+		stm32_cryp_gcm_batch(b->gcm, nb_ready);
+
+		for (idx = 0; idx < nb_ready; idx++)
+			b->job[idx]->res = stm32_ae_batch_complete(b, idx);
+	}
+
+	for (n = 0; n < count; n++) {
+		if (jobs[n].res) {
+			res = jobs[n].res;
+			break;
+		}
+	}
+
+	free_wipe(b);
+
+	return res;
+}
+
 static TEE_Result alloc_ctx(void **ctx, enum stm32_cryp_algo_mode algo)
 {
 	struct stm32_ae_ctx *c = calloc(1, sizeof(*c));
@@ -364,6 +505,7 @@ static struct drvcrypt_authenc driver_authenc = {
 	.dec_final = stm32_ae_dec_final,
 	.final = stm32_ae_final,
 	.copy_state = stm32_ae_copy_state,
+	.batch = stm32_ae_batch,
 };
 
 TEE_Result stm32_register_authenc(void)
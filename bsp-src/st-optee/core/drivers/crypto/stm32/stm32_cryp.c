@@ -1229,6 +1229,178 @@ out:
 	return res;
 }
 
+/* Move a running GCM operation to @new_phase, CRYP must not be suspended */
+static TEE_Result gcm_move_to_phase(struct stm32_cryp_context *ctx,
+				    uint32_t new_phase)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	res = wait_end_busy(ctx->base);
+	if (res)
+		return res;
+
+	io_clrbits32(ctx->base + _CRYP_CR, _CRYP_CR_CRYPEN);
+	io_clrsetbits32(ctx->base + _CRYP_CR, _CRYP_CR_GCM_CCMPH_MSK,
+			new_phase << _CRYP_CR_GCM_CCMPH_OFF);
+	io_setbits32(ctx->base + _CRYP_CR, _CRYP_CR_CRYPEN);
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Process a complete GCM operation without suspending it. The key and
+ * initial counter are loaded once and no context is saved or restored
+ * between the header, payload and final phases. Payload blocks are kept
+ * one ahead in the CRYP input FIFO so that the next block is processed
+ * while the CPU reads the previous one.
+ */
+static TEE_Result gcm_oneshot(struct stm32_cryp_gcm_job *job)
+{
+	struct stm32_cryp_context *ctx = job->ctx;
+	size_t block_size = ctx->block_u32 * sizeof(uint32_t);
+	size_t nb_blocks = job->data_size / block_size;
+	uint32_t block[MAX_BLOCK_NB_U32] = { 0 };
+	uint32_t tag_u32[AES_BLOCK_NB_U32] = { 0 };
+	uint32_t phase = _CRYP_CR_GCM_CCMPH_FINAL;
+	TEE_Result res = TEE_SUCCESS;
+	size_t rem = 0;
+	size_t i = 0;
+
+	if (!IS_ALGOMODE(ctx->cr, AES_GCM))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (job->aad_size)
+		phase = _CRYP_CR_GCM_CCMPH_HEADER;
+	else if (job->data_size)
+		phase = _CRYP_CR_GCM_CCMPH_PAYLOAD;
+
+	res = do_from_init_to_phase(ctx, phase);
+	if (res)
+		return res;
+
+	if (job->aad_size) {
+		for (i = 0; i + block_size <= job->aad_size; i += block_size) {
+			res = write_block(ctx, job->aad + i);
+			if (res)
+				return res;
+		}
+
+		rem = job->aad_size - i;
+		if (rem) {
+			memcpy(block, job->aad + i, rem);
+			res = write_align_block(ctx, block);
+			if (res)
+				return res;
+		}
+
+		ctx->assoc_len = job->aad_size * INT8_BIT;
+
+		if (job->data_size)
+			phase = _CRYP_CR_GCM_CCMPH_PAYLOAD;
+		else
+			phase = _CRYP_CR_GCM_CCMPH_FINAL;
+
+		res = gcm_move_to_phase(ctx, phase);
+		if (res)
+			return res;
+	}
+
+	if (job->data_size) {
+		if (nb_blocks) {
+			res = write_block(ctx, job->data_in);
+			if (res)
+				return res;
+		}
+
+		for (i = 0; i < nb_blocks; i++) {
+			if (i + 1 < nb_blocks) {
+				res = write_block(ctx, job->data_in +
+						  (i + 1) * block_size);
+				if (res)
+					return res;
+			}
+
+			res = read_block(ctx, job->data_out + i * block_size);
+			if (res)
+				return res;
+		}
+
+		rem = job->data_size - nb_blocks * block_size;
+		if (rem) {
+			if (does_need_npblb(ctx->cr))
+				io_clrsetbits32(ctx->base + _CRYP_CR,
+						_CRYP_CR_NPBLB_MSK,
+						(block_size - rem) <<
+						_CRYP_CR_NPBLB_OFF);
+
+			memset(block, 0, sizeof(block));
+			memcpy(block, job->data_in + nb_blocks * block_size,
+			       rem);
+
+			res = write_align_block(ctx, block);
+			if (res)
+				return res;
+
+			res = read_align_block(ctx, block);
+			if (res)
+				return res;
+
+			memcpy(job->data_out + nb_blocks * block_size, block,
+			       rem);
+		}
+
+		ctx->load_len = job->data_size * INT8_BIT;
+
+		res = gcm_move_to_phase(ctx, _CRYP_CR_GCM_CCMPH_FINAL);
+		if (res)
+			return res;
+	}
+
+	/* No need to htobe() as we configure the HW to swap bytes */
+	io_write32(ctx->base + _CRYP_DIN, 0U);
+	io_write32(ctx->base + _CRYP_DIN, ctx->assoc_len);
+	io_write32(ctx->base + _CRYP_DIN, 0U);
+	io_write32(ctx->base + _CRYP_DIN, ctx->load_len);
+
+	res = read_align_block(ctx, tag_u32);
+	if (res)
+		return res;
+
+	memcpy(job->tag, tag_u32, sizeof(job->tag));
+
+	return TEE_SUCCESS;
+}
+
+/**
+ * @brief Process a batch of single-shot AES GCM operations.
+ * @param jobs: operations, each with a context set up by stm32_cryp_init()
+ * @param count: number of operations
+ * @note the CRYP is held for the whole batch, each job reports its own
+ *       result in its res field
+ *
+ * @retval TEE_SUCCESS if all operations succeeded, first error otherwise.
+ */
+TEE_Result stm32_cryp_gcm_batch(struct stm32_cryp_gcm_job *jobs,
+				size_t count)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	mutex_lock(&cryp_lock);
+
+	for (n = 0; n < count; n++) {
+		jobs[n].res = gcm_oneshot(jobs + n);
+		cryp_end(jobs[n].ctx, jobs[n].res);
+
+		if (jobs[n].res && !res)
+			res = jobs[n].res;
+	}
+
+	mutex_unlock(&cryp_lock);
+
+	return res;
+}
+
 static TEE_Result stm32_cryp_probe(const void *fdt, int node,
 				   const void *compt_data __unused)
 {
@@ -75,4 +75,29 @@ TEE_Result stm32_cryp_update_load(struct stm32_cryp_context *ctx,
 				  size_t data_size);
 TEE_Result stm32_cryp_final(struct stm32_cryp_context *ctx, uint8_t *tag,
 			    size_t tag_size);
+
+/*
+ * Single-shot AES GCM operation processed by stm32_cryp_gcm_batch()
+ * @ctx - CRYP context set up with stm32_cryp_init()
+ * @aad - Associated data
+ * @aad_size - Associated data size in bytes
+ * @data_in - Input payload
+ * @data_out - Output payload
+ * @data_size - Payload size in bytes
+ * @tag - Tag computed by the CRYP, before any J0 mask correction
+ * @res - Result of the operation
+ */
+struct stm32_cryp_gcm_job {
+	struct stm32_cryp_context *ctx;
+	uint8_t *aad;
+	size_t aad_size;
+	uint8_t *data_in;
+	uint8_t *data_out;
+	size_t data_size;
+	uint8_t tag[16];
+	TEE_Result res;
+};
+
+TEE_Result stm32_cryp_gcm_batch(struct stm32_cryp_gcm_job *jobs,
+				size_t count);
 #endif
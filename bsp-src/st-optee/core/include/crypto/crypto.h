@@ -83,6 +83,48 @@ void crypto_authenc_final(void *ctx);
 void crypto_authenc_free_ctx(void *ctx);
 void crypto_authenc_copy_state(void *dst_ctx, void *src_ctx);
 
+/*
+ * struct crypto_authenc_job - Single-shot authenticated encryption operation
+ * @mode:	TEE_MODE_ENCRYPT or TEE_MODE_DECRYPT
+ * @key:	Key
+ * @key_len:	Length of @key in bytes
+ * @nonce:	Nonce
+ * @nonce_len:	Length of @nonce in bytes
+ * @aad:	Additional authenticated data, may be NULL if @aad_len is 0
+ * @aad_len:	Length of @aad in bytes
+ * @src:	Input payload, may be NULL if @len is 0
+ * @dst:	Output payload, may be NULL if @len is 0, may be equal to @src
+ * @len:	Length of @src and @dst in bytes
+ * @tag:	Tag, output on encryption, input on decryption
+ * @tag_len:	Length of @tag in bytes
+ * @res:	[out] Result of the operation
+ */
+struct crypto_authenc_job {
+	TEE_OperationMode mode;
+	const uint8_t *key;
+	size_t key_len;
+	const uint8_t *nonce;
+	size_t nonce_len;
+	const uint8_t *aad;
+	size_t aad_len;
+	const uint8_t *src;
+	uint8_t *dst;
+	size_t len;
+	uint8_t *tag;
+	size_t tag_len;
+	TEE_Result res;
+};
+
+/*
+ * Process @count independent single-shot operations of algorithm @algo.
+ * A crypto driver may pipeline the jobs, otherwise they are processed one
+ * after the other. All jobs are processed, each job result is reported in
+ * its @res field. Returns TEE_SUCCESS if all jobs succeeded, otherwise the
+ * result of the first failing job.
+ */
+TEE_Result crypto_authenc_batch(uint32_t algo, struct crypto_authenc_job *jobs,
+				size_t count);
+
 /* Informs crypto that the data in the buffer will be removed from storage */
 TEE_Result crypto_storage_obj_del(struct tee_obj *obj);
 
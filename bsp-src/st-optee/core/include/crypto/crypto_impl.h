@@ -392,6 +392,10 @@ drvcrypt_mac_alloc_ctx(struct crypto_mac_ctx **ctx __unused,
 /* Cryptographic Authenticated Encryption driver context allocation */
 TEE_Result drvcrypt_authenc_alloc_ctx(struct crypto_authenc_ctx **ctx,
 				      uint32_t algo);
+/* Cryptographic Authenticated Encryption driver batch processing */
+TEE_Result drvcrypt_authenc_batch(uint32_t algo,
+				  struct crypto_authenc_job *jobs,
+				  size_t count);
 #else
 static inline TEE_Result
 drvcrypt_authenc_alloc_ctx(struct crypto_authenc_ctx **ctx __unused,
@@ -399,6 +403,14 @@ drvcrypt_authenc_alloc_ctx(struct crypto_authenc_ctx **ctx __unused,
 {
 	return TEE_ERROR_NOT_IMPLEMENTED;
 }
+
+static inline TEE_Result
+drvcrypt_authenc_batch(uint32_t algo __unused,
+		       struct crypto_authenc_job *jobs __unused,
+		       size_t count __unused)
+{
+	return TEE_ERROR_NOT_IMPLEMENTED;
+}
 #endif /* CFG_CRYPTO_DRV_AUTHENC */
 /*
  * The ECC public key operations used by the crypto_acipher_ecc_*() and
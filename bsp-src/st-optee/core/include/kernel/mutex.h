@@ -5,15 +5,42 @@
 #ifndef __KERNEL_MUTEX_H
 #define __KERNEL_MUTEX_H
 
+#include <compiler.h>
 #include <kernel/refcount.h>
 #include <kernel/wait_queue.h>
 #include <sys/queue.h>
 #include <types_ext.h>
 
+struct mutex;
+
+/*
+ * struct mutex_stats - Contention statistics of a registered mutex
+ * @name: Name reported through the stats PTA
+ * @locked: Number of times the mutex was acquired (read or write)
+ * @contended: Number of acquisitions that found the mutex already held
+ * @spin_acquired: Contended acquisitions resolved by spinning
+ * @sleeps: Number of sleeps in normal world waiting for the mutex
+ * @max_spin_us: Longest spin duration in microseconds
+ * @link: Link in the list of registered mutexes
+ */
+struct mutex_stats {
+	const char *name;
+	uint32_t locked;
+	uint32_t contended;
+	uint32_t spin_acquired;
+	uint32_t sleeps;
+	uint32_t max_spin_us;
+	SLIST_ENTRY(mutex) link;
+};
+
 struct mutex {
 	unsigned spin_lock;	/* used when operating on this struct */
 	struct wait_queue wq;
 	short state;		/* -1: write, 0: unlocked, > 0: readers */
+	short owner;		/* Write lock owner thread, valid if state == -1 */
+#ifdef CFG_MUTEX_STATS
+	struct mutex_stats stats;
+#endif
 };
 
 #define MUTEX_INITIALIZER { .wq = WAIT_QUEUE_INITIALIZER }
@@ -32,6 +59,27 @@ TAILQ_HEAD(mutex_head, mutex);
 void mutex_init(struct mutex *m);
 void mutex_destroy(struct mutex *m);
 
+#ifdef CFG_MUTEX_STATS
+/*
+ * Registers @m under @name so that its contention statistics are reported
+ * through the stats PTA. A registered mutex is unregistered by
+ * mutex_destroy().
+ */
+void mutex_stats_register(struct mutex *m, const char *name);
+
+/*
+ * Copies the statistics of up to @count registered mutexes into @stats and
+ * returns the total number of registered mutexes. Statistics are cleared
+ * after being read when @reset is true and all of them fit in @stats.
+ */
+size_t mutex_stats_get(struct mutex_stats *stats, size_t count, bool reset);
+#else
+static inline void mutex_stats_register(struct mutex *m __unused,
+					const char *name __unused)
+{
+}
+#endif
+
 void mutex_init_recursive(struct recursive_mutex *m);
 void mutex_destroy_recursive(struct recursive_mutex *m);
 unsigned int mutex_get_recursive_lock_depth(struct recursive_mutex *m);
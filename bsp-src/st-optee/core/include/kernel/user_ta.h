@@ -26,6 +26,7 @@ SLIST_HEAD(load_seg_head, load_seg);
  * struct user_ta_ctx - user TA context
  * @open_sessions:	List of sessions opened by this TA
  * @cryp_states:	List of cryp states created by this TA
+ * @cryp_pool:		List of released cryp states kept for reuse
  * @objects:		List of storage objects opened by this TA
  * @storage_enums:	List of storage enumerators opened by this TA
  * @ta_time_offs:	Time reference used by the TA
@@ -35,6 +36,7 @@ SLIST_HEAD(load_seg_head, load_seg);
 struct user_ta_ctx {
 	struct tee_ta_session_head open_sessions;
 	struct tee_cryp_state_head cryp_states;
+	struct tee_cryp_state_head cryp_pool;
 	struct tee_obj_head objects;
 	struct tee_storage_enum_head storage_enums;
 	void *ta_time_offs;
@@ -37,6 +37,9 @@ TEE_Result syscall_cryp_state_copy(unsigned long dst, unsigned long src);
 TEE_Result syscall_cryp_state_free(unsigned long state);
 void tee_svc_cryp_free_states(struct user_ta_ctx *utc);
 
+/* Get the number of crypto state allocations served from/missing the pool */
+void tee_svc_cryp_get_pool_stats(uint32_t *hits, uint32_t *misses);
+
 /* iv and iv_len are ignored for hash algorithms */
 TEE_Result syscall_hash_init(unsigned long state, const void *iv,
 			size_t iv_len);
@@ -3,16 +3,163 @@
  * Copyright (c) 2015-2017, Linaro Limited
  */
 
+#include <atomic.h>
+#include <kernel/delay.h>
 #include <kernel/mutex.h>
 #include <kernel/mutex_pm_aware.h>
 #include <kernel/panic.h>
 #include <kernel/refcount.h>
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
+#include <kernel/thread_private.h>
 #include <trace.h>
 
 #include "mutex_lockdep.h"
 
+#ifdef CFG_MUTEX_STATS
+static SLIST_HEAD(, mutex) mutex_stats_head =
+	SLIST_HEAD_INITIALIZER(mutex_stats_head);
+static unsigned int mutex_stats_lock = SPINLOCK_UNLOCK;
+
+void mutex_stats_register(struct mutex *m, const char *name)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&mutex_stats_lock);
+
+	m->stats.name = name;
+	SLIST_INSERT_HEAD(&mutex_stats_head, m, stats.link);
+
+	cpu_spin_unlock_xrestore(&mutex_stats_lock, exceptions);
+}
+
+static void mutex_stats_unregister(struct mutex *m)
+{
+	uint32_t exceptions = 0;
+
+	if (!m->stats.name)
+		return;
+
+	exceptions = cpu_spin_lock_xsave(&mutex_stats_lock);
+	SLIST_REMOVE(&mutex_stats_head, m, mutex, stats.link);
+	cpu_spin_unlock_xrestore(&mutex_stats_lock, exceptions);
+}
+
+size_t mutex_stats_get(struct mutex_stats *stats, size_t count, bool reset)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&mutex_stats_lock);
+	struct mutex *m = NULL;
+	size_t n = 0;
+
+	/* Statistics are only cleared when they are all returned */
+	if (reset) {
+		SLIST_FOREACH(m, &mutex_stats_head, stats.link)
+			n++;
+		reset = n <= count;
+		n = 0;
+	}
+
+	SLIST_FOREACH(m, &mutex_stats_head, stats.link) {
+		if (n < count) {
+			cpu_spin_lock(&m->spin_lock);
+			stats[n] = m->stats;
+			if (reset) {
+				m->stats.locked = 0;
+				m->stats.contended = 0;
+				m->stats.spin_acquired = 0;
+				m->stats.sleeps = 0;
+				m->stats.max_spin_us = 0;
+			}
+			cpu_spin_unlock(&m->spin_lock);
+		}
+		n++;
+	}
+
+	cpu_spin_unlock_xrestore(&mutex_stats_lock, exceptions);
+
+	return n;
+}
+
+/* Must be called with m->spin_lock held */
+static void mutex_stats_locked(struct mutex *m, bool contended,
+			       uint64_t spin_cnt)
+{
+	uint32_t spin_us = 0;
+
+	m->stats.locked++;
+	if (!contended)
+		return;
+
+	m->stats.contended++;
+	if (spin_cnt) {
+		m->stats.spin_acquired++;
+		spin_us = (spin_cnt * 1000000ULL) / read_cntfrq();
+		if (spin_us > m->stats.max_spin_us)
+			m->stats.max_spin_us = spin_us;
+	}
+}
+
+/* Must be called with m->spin_lock held */
+static void mutex_stats_sleep(struct mutex *m)
+{
+	m->stats.sleeps++;
+}
+#else
+static void mutex_stats_unregister(struct mutex *m __unused)
+{
+}
+
+static void mutex_stats_locked(struct mutex *m __unused,
+			       bool contended __unused,
+			       uint64_t spin_cnt __unused)
+{
+}
+
+static void mutex_stats_sleep(struct mutex *m __unused)
+{
+}
+#endif /*CFG_MUTEX_STATS*/
+
+/*
+ * Returns true if a contended locker should spin rather than sleep in
+ * normal world. Spinning only pays off while the write lock owner is
+ * running, that is, while its thread is active on another core: a
+ * suspended owner waits for normal world itself. Must be called with
+ * m->spin_lock held. @spin_end is 0 until spinning is first considered,
+ * then holds the counter value at which spinning must stop.
+ */
+static bool mutex_can_spin(struct mutex *m, uint64_t *spin_end)
+{
+	short owner = m->owner;
+
+	if (!CFG_MUTEX_SPIN_US || m->state != -1)
+		return false;
+
+	if (owner == thread_get_id() ||
+	    threads[owner].state != THREAD_STATE_ACTIVE)
+		return false;
+
+	if (!*spin_end) {
+		*spin_end = timeout_init_us(CFG_MUTEX_SPIN_US);
+		return true;
+	}
+
+	return !timeout_elapsed(*spin_end);
+}
+
+/*
+ * Busy-waits without holding m->spin_lock until the mutex looks
+ * available to the caller or the spin budget is exhausted.
+ */
+static void mutex_spin(struct mutex *m, uint64_t spin_end, bool wait_read)
+{
+	short state = 0;
+
+	while (!timeout_elapsed(spin_end)) {
+		state = atomic_load_short(&m->state);
+		if (wait_read ? state != -1 : !state)
+			break;
+	}
+}
+
 void mutex_init(struct mutex *m)
 {
 	*m = (struct mutex)MUTEX_INITIALIZER;
@@ -25,6 +172,10 @@ void mutex_init_recursive(struct recursive_mutex *m)
 
 static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 {
+	uint64_t spin_start = 0;
+	uint64_t spin_end = 0;
+	bool contended = false;
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
 	assert(thread_is_in_normal_mode());
@@ -34,6 +185,7 @@ static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 	while (true) {
 		uint32_t old_itr_status;
 		bool can_lock;
+		bool do_spin = false;
 		struct wait_queue_elem wqe;
 
 		/*
@@ -42,28 +194,47 @@ static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 		 * miss the wakeup from mutex_unlock().
 		 *
 		 * If the mutex is unlocked we don't need to use the wqe at
-		 * all.
+		 * all. Neither do we if the owner is running on another
+		 * core and we can afford spinning a bit more for it to
+		 * release the mutex.
 		 */
 
 		old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 		can_lock = !m->state;
 		if (!can_lock) {
-			wq_wait_init(&m->wq, &wqe, false /* wait_read */);
+			contended = true;
+			do_spin = mutex_can_spin(m, &spin_end);
+			if (do_spin) {
+				if (!spin_start)
+					spin_start = barrier_read_counter_timer();
+			} else {
+				spin_start = 0;
+				mutex_stats_sleep(m);
+				wq_wait_init(&m->wq, &wqe, false /* wait_read */);
+			}
 		} else {
 			m->state = -1; /* write locked */
+			m->owner = thread_get_id();
+			mutex_stats_locked(m, contended, spin_start ?
+					   barrier_read_counter_timer() -
+					   spin_start : 0);
 		}
 
 		cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-		if (!can_lock) {
+		if (can_lock)
+			return;
+
+		if (do_spin) {
+			mutex_spin(m, spin_end, false /* wait_read */);
+		} else {
 			/*
 			 * Someone else is holding the lock, wait in normal
 			 * world for the lock to become available.
 			 */
 			wq_wait_final(&m->wq, &wqe, m, fname, lineno);
-		} else
-			return;
+		}
 	}
 }
 
@@ -137,8 +308,11 @@ static bool __mutex_trylock(struct mutex *m, const char *fname __unused,
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 	can_lock_write = !m->state;
-	if (can_lock_write)
+	if (can_lock_write) {
 		m->state = -1;
+		m->owner = thread_get_id();
+		mutex_stats_locked(m, false, 0);
+	}
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
@@ -172,6 +346,10 @@ static void __mutex_read_unlock(struct mutex *m, const char *fname, int lineno)
 
 static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 {
+	uint64_t spin_start = 0;
+	uint64_t spin_end = 0;
+	bool contended = false;
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
 	assert(thread_is_in_normal_mode());
@@ -179,6 +357,7 @@ static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 	while (true) {
 		uint32_t old_itr_status;
 		bool can_lock;
+		bool do_spin = false;
 		struct wait_queue_elem wqe;
 
 		/*
@@ -187,28 +366,46 @@ static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 		 * miss the wakeup from mutex_unlock().
 		 *
 		 * If the mutex is unlocked we don't need to use the wqe at
-		 * all.
+		 * all. Neither do we if the writer is running on another
+		 * core and we can afford spinning a bit more for it to
+		 * release the mutex.
 		 */
 
 		old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 		can_lock = m->state != -1;
 		if (!can_lock) {
-			wq_wait_init(&m->wq, &wqe, true /* wait_read */);
+			contended = true;
+			do_spin = mutex_can_spin(m, &spin_end);
+			if (do_spin) {
+				if (!spin_start)
+					spin_start = barrier_read_counter_timer();
+			} else {
+				spin_start = 0;
+				mutex_stats_sleep(m);
+				wq_wait_init(&m->wq, &wqe, true /* wait_read */);
+			}
 		} else {
 			m->state++; /* read_locked */
+			mutex_stats_locked(m, contended, spin_start ?
+					   barrier_read_counter_timer() -
+					   spin_start : 0);
 		}
 
 		cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-		if (!can_lock) {
+		if (can_lock)
+			return;
+
+		if (do_spin) {
+			mutex_spin(m, spin_end, true /* wait_read */);
+		} else {
 			/*
 			 * Someone else is holding the lock, wait in normal
 			 * world for the lock to become available.
 			 */
 			wq_wait_final(&m->wq, &wqe, m, fname, lineno);
-		} else
-			return;
+		}
 	}
 }
 
@@ -225,8 +422,10 @@ static bool __mutex_read_trylock(struct mutex *m, const char *fname __unused,
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 	can_lock = m->state != -1;
-	if (can_lock)
+	if (can_lock) {
 		m->state++;
+		mutex_stats_locked(m, false, 0);
+	}
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
@@ -327,6 +526,7 @@ void mutex_destroy(struct mutex *m)
 		panic();
 	if (!wq_is_empty(&m->wq))
 		panic("waitqueue not empty");
+	mutex_stats_unregister(m);
 	mutex_destroy_check(m);
 }
 
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <initcall.h>
 #include <kernel/mutex.h>
 #include <kernel/panic.h>
 #include <kernel/pseudo_ta.h>
@@ -55,6 +56,14 @@ struct mutex tee_ta_mutex = MUTEX_INITIALIZER;
 struct condvar tee_ta_init_cv = CONDVAR_INITIALIZER;
 struct tee_ta_ctx_head tee_ctxes = TAILQ_HEAD_INITIALIZER(tee_ctxes);
 
+static TEE_Result tee_ta_mutex_stats_init(void)
+{
+	mutex_stats_register(&tee_ta_mutex, "tee_ta_mutex");
+
+	return TEE_SUCCESS;
+}
+early_init(tee_ta_mutex_stats_init);
+
 #ifndef CFG_CONCURRENT_SINGLE_INSTANCE_TA
 static struct condvar tee_ta_cv = CONDVAR_INITIALIZER;
 static short int tee_ta_single_instance_thread = THREAD_ID_INVALID;
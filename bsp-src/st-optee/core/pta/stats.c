@@ -5,6 +5,7 @@
 #include <compiler.h>
 #include <drivers/clk.h>
 #include <drivers/regulator.h>
+#include <kernel/mutex.h>
 #include <kernel/pseudo_ta.h>
 #include <kernel/tee_time.h>
 #include <malloc.h>
@@ -14,6 +15,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <string_ext.h>
+#include <tee/tee_svc_cryp.h>
 #include <tee_api_types.h>
 #include <trace.h>
 
@@ -175,6 +177,80 @@ static TEE_Result get_system_time(uint32_t type,
 	return TEE_SUCCESS;
 }
 
+#ifdef CFG_MUTEX_STATS
+static TEE_Result get_mutex_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct pta_stats_mutex *out = NULL;
+	struct mutex_stats *stats = NULL;
+	size_t count = 0;
+	size_t n = 0;
+	size_t i = 0;
+
+	/*
+	 * p[0].value.a = 0 if no reset of the stats
+	 * p[1].memref.buffer = output buffer to struct pta_stats_mutex
+	 */
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	out = p[1].memref.buffer;
+	count = p[1].memref.size / sizeof(*out);
+	if (count) {
+		stats = calloc(count, sizeof(*stats));
+		if (!stats)
+			return TEE_ERROR_OUT_OF_MEMORY;
+	}
+
+	n = mutex_stats_get(stats, count, !!p[0].value.a);
+	if (n > count) {
+		free(stats);
+		p[1].memref.size = n * sizeof(*out);
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	for (i = 0; i < n; i++) {
+		strlcpy(out[i].desc, stats[i].name, sizeof(out[i].desc));
+		out[i].locked = stats[i].locked;
+		out[i].contended = stats[i].contended;
+		out[i].spin_acquired = stats[i].spin_acquired;
+		out[i].sleeps = stats[i].sleeps;
+		out[i].max_spin_us = stats[i].max_spin_us;
+	}
+	p[1].memref.size = n * sizeof(*out);
+	free(stats);
+
+	return TEE_SUCCESS;
+}
+#else
+static TEE_Result get_mutex_stats(uint32_t type __unused,
+				  TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+static TEE_Result get_cryp_pool_stats(uint32_t type,
+				      TEE_Param p[TEE_NUM_PARAMS])
+{
+	uint32_t hits = 0;
+	uint32_t misses = 0;
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	tee_svc_cryp_get_pool_stats(&hits, &misses);
+	p[0].value.a = hits;
+	p[0].value.b = misses;
+
+	return TEE_SUCCESS;
+}
+
 static TEE_Result print_driver_info(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
 {
 	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
@@ -218,6 +294,10 @@ static TEE_Result invoke_command(void *psess __unused,
 		return get_system_time(ptypes, params);
 	case STATS_CMD_PRINT_DRIVER_INFO:
 		return print_driver_info(ptypes, params);
+	case STATS_CMD_MUTEX_STATS:
+		return get_mutex_stats(ptypes, params);
+	case STATS_CMD_CRYP_POOL_STATS:
+		return get_cryp_pool_stats(ptypes, params);
 	default:
 		break;
 	}
@@ -7,11 +7,14 @@
 #include <crypto/crypto.h>
 #include <kernel/tee_time.h>
 #include <pta_invoke_tests.h>
+#include <stdlib.h>
+#include <string.h>
 #include <tee_api_defines.h>
 #include <tee_api_types.h>
 #include <trace.h>
 #include <types_ext.h>
 #include <utee_defines.h>
+#include <util.h>
 
 #include "misc.h"
 
@@ -220,3 +223,169 @@ TEE_Result core_aes_perf_tests(uint32_t param_types,
 	free_ctx(&ctx, algo);
 	return res;
 }
+
+#define GCM_BATCH_NONCE_SIZE	12
+
+static TEE_Result gcm_single(void *ctx, struct crypto_authenc_job *job)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t tag_len = job->tag_len;
+	size_t dst_len = job->len;
+
+	res = crypto_authenc_init(ctx, job->mode, job->key, job->key_len,
+				  job->nonce, job->nonce_len, job->tag_len, 0,
+				  job->len);
+	if (res)
+		return res;
+
+	if (job->mode == TEE_MODE_ENCRYPT)
+		res = crypto_authenc_enc_final(ctx, job->src, job->len,
+					       job->dst, &dst_len, job->tag,
+					       &tag_len);
+	else
+		res = crypto_authenc_dec_final(ctx, job->src, job->len,
+					       job->dst, &dst_len, job->tag,
+					       job->tag_len);
+
+	crypto_authenc_final(ctx);
+
+	return res;
+}
+
+static TEE_Result gcm_run_jobs(uint32_t method, struct crypto_authenc_job *jobs,
+			       size_t count)
+{
+	TEE_Result res = TEE_SUCCESS;
+	void *ctx = NULL;
+	size_t n = 0;
+
+	if (method == PTA_INVOKE_TESTS_AES_GCM_BATCH)
+		return crypto_authenc_batch(TEE_ALG_AES_GCM, jobs, count);
+
+	res = crypto_authenc_alloc_ctx(&ctx, TEE_ALG_AES_GCM);
+	if (res)
+		return res;
+
+	for (n = 0; n < count; n++) {
+		res = gcm_single(ctx, jobs + n);
+		if (res)
+			break;
+	}
+
+	crypto_authenc_free_ctx(ctx);
+
+	return res;
+}
+
+static void gcm_set_jobs(struct crypto_authenc_job *jobs, size_t count,
+			 TEE_OperationMode mode, size_t key_len,
+			 const uint8_t *src, uint8_t *dst, size_t sz,
+			 size_t unit_size, uint8_t *nonces, uint8_t *tags)
+{
+	size_t n = 0;
+
+	for (n = 0; n < count; n++) {
+		jobs[n] = (struct crypto_authenc_job){
+			.mode = mode,
+			.key = aes_key,
+			.key_len = key_len,
+			.nonce = nonces + n * GCM_BATCH_NONCE_SIZE,
+			.nonce_len = GCM_BATCH_NONCE_SIZE,
+			.src = src + n * unit_size,
+			.dst = dst + n * unit_size,
+			.len = MIN(unit_size, sz - n * unit_size),
+			.tag = tags + n * TEE_AES_BLOCK_SIZE,
+			.tag_len = TEE_AES_BLOCK_SIZE,
+		};
+	}
+}
+
+TEE_Result core_aes_gcm_batch_perf_tests(uint32_t param_types,
+					 TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_param_types = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_VALUE_INPUT,
+						   TEE_PARAM_TYPE_MEMREF_INOUT,
+						   TEE_PARAM_TYPE_MEMREF_INOUT);
+	TEE_Result res = TEE_SUCCESS;
+	struct crypto_authenc_job *jobs = NULL;
+	uint8_t *nonces = NULL;
+	uint8_t *tags = NULL;
+	uint8_t *in = NULL;
+	uint8_t *out = NULL;
+	unsigned int rep_count = 0;
+	unsigned int unit_size = 0;
+	uint32_t method = 0;
+	uint32_t be_idx = 0;
+	size_t key_len = 0;
+	size_t count = 0;
+	size_t sz = 0;
+	size_t n = 0;
+
+	if (param_types != exp_param_types)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	method = params[0].value.b;
+	if (method != PTA_INVOKE_TESTS_AES_GCM_SINGLE &&
+	    method != PTA_INVOKE_TESTS_AES_GCM_BATCH)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if ((params[0].value.a & 0xffff) % 8)
+		return TEE_ERROR_BAD_PARAMETERS;
+	key_len = (params[0].value.a & 0xffff) / 8;
+	if (key_len > sizeof(aes_key))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	rep_count = params[1].value.a;
+	unit_size = params[1].value.b;
+
+	in = params[2].memref.buffer;
+	out = params[3].memref.buffer;
+	sz = params[2].memref.size;
+	if (!sz || !unit_size || sz > params[3].memref.size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	count = ROUNDUP_DIV(sz, unit_size);
+	jobs = calloc(count, sizeof(*jobs));
+	nonces = calloc(count, GCM_BATCH_NONCE_SIZE);
+	tags = calloc(count, TEE_AES_BLOCK_SIZE);
+	if (!jobs || !nonces || !tags) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	/* Each job uses its own nonce: IV prefix and big endian job index */
+	for (n = 0; n < count; n++) {
+		be_idx = TEE_U32_TO_BIG_ENDIAN(n);
+		memcpy(nonces + n * GCM_BATCH_NONCE_SIZE, aes_iv,
+		       GCM_BATCH_NONCE_SIZE - sizeof(be_idx));
+		memcpy(nonces + (n + 1) * GCM_BATCH_NONCE_SIZE -
+		       sizeof(be_idx), &be_idx, sizeof(be_idx));
+	}
+
+	gcm_set_jobs(jobs, count, TEE_MODE_ENCRYPT, key_len, in, out, sz,
+		     unit_size, nonces, tags);
+
+	if (params[0].value.a >> 16) {
+		/* Produce authentic messages, then decrypt them back to in */
+		res = crypto_authenc_batch(TEE_ALG_AES_GCM, jobs, count);
+		if (res)
+			goto out;
+
+		gcm_set_jobs(jobs, count, TEE_MODE_DECRYPT, key_len, out, in,
+			     sz, unit_size, nonces, tags);
+	}
+
+	for (n = 0; n < rep_count; n++) {
+		res = gcm_run_jobs(method, jobs, count);
+		if (res)
+			break;
+	}
+
+out:
+	free(jobs);
+	free(nonces);
+	free(tags);
+
+	return res;
+}
@@ -33,6 +33,8 @@ static inline TEE_Result core_lockdep_tests(
 
 TEE_Result core_aes_perf_tests(uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS]);
+TEE_Result core_aes_gcm_batch_perf_tests(uint32_t param_types,
+					 TEE_Param params[TEE_NUM_PARAMS]);
 
 TEE_Result core_dt_driver_tests(uint32_t param_types,
 				TEE_Param params[TEE_NUM_PARAMS]);
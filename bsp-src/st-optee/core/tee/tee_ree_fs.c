@@ -5,6 +5,7 @@
 
 #include <assert.h>
 #include <config.h>
+#include <initcall.h>
 #include <kernel/mutex.h>
 #include <kernel/nv_counter.h>
 #include <kernel/panic.h>
@@ -53,6 +54,14 @@ static int pos_to_block_num(int position)
 
 static struct mutex ree_fs_mutex = MUTEX_INITIALIZER;
 
+static TEE_Result ree_fs_mutex_stats_init(void)
+{
+	mutex_stats_register(&ree_fs_mutex, "ree_fs_mutex");
+
+	return TEE_SUCCESS;
+}
+early_init(ree_fs_mutex_stats_init);
+
 static void *get_tmp_block(void)
 {
 	return mempool_alloc(mempool_default, BLOCK_SIZE);
@@ -6,6 +6,7 @@
  */
 
 #include <assert.h>
+#include <atomic.h>
 #include <bitstring.h>
 #include <compiler.h>
 #include <config.h>
@@ -2582,19 +2583,8 @@ static TEE_Result tee_svc_cryp_get_state(struct ts_session *sess,
 	return TEE_ERROR_BAD_PARAMETERS;
 }
 
-static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
+static void cryp_state_free_ctx(struct tee_cryp_state *cs)
 {
-	struct tee_obj *o;
-
-	if (tee_obj_get(utc, cs->key1, &o) == TEE_SUCCESS)
-		tee_obj_close(utc, o);
-	if (tee_obj_get(utc, cs->key2, &o) == TEE_SUCCESS)
-		tee_obj_close(utc, o);
-
-	TAILQ_REMOVE(&utc->cryp_states, cs, link);
-	if (cs->ctx_finalize != NULL)
-		cs->ctx_finalize(cs->ctx);
-
 	switch (TEE_ALG_GET_CLASS(cs->algo)) {
 	case TEE_OPERATION_CIPHER:
 		crypto_cipher_free_ctx(cs->ctx);
@@ -2615,6 +2605,174 @@ static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
 	free(cs);
 }
 
+/*
+ * Crypto state pool
+ *
+ * TAs running TLS-like workloads allocate and release many short lived
+ * operations. Released states that own a crypto context are kept in a
+ * small per-TA context pool, up to CFG_CRYPTO_STATE_POOL_SIZE states, so
+ * that a later allocation for the same algorithm reuses the context
+ * rather than allocating and setting up a new one. A crypto context only
+ * depends on the algorithm, not on the key size, hence pooled states are
+ * looked up by algorithm. Contexts are finalized when released and
+ * reinitialized, with a new key where applicable, before being used
+ * again. Before a context enters the pool, its key material is
+ * overwritten by setting it up with an all-zero key of the same size.
+ */
+static uint32_t cryp_pool_hits;
+static uint32_t cryp_pool_misses;
+
+void tee_svc_cryp_get_pool_stats(uint32_t *hits, uint32_t *misses)
+{
+	*hits = atomic_load_u32(&cryp_pool_hits);
+	*misses = atomic_load_u32(&cryp_pool_misses);
+}
+
+static bool cryp_state_is_poolable(uint32_t algo)
+{
+	if (!CFG_CRYPTO_STATE_POOL_SIZE)
+		return false;
+
+	switch (TEE_ALG_GET_CLASS(algo)) {
+	case TEE_OPERATION_CIPHER:
+	case TEE_OPERATION_AE:
+	case TEE_OPERATION_DIGEST:
+	case TEE_OPERATION_MAC:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static struct tee_cryp_state *cryp_pool_get(struct user_ta_ctx *utc,
+					    uint32_t algo)
+{
+	struct tee_cryp_state *cs = NULL;
+
+	if (!cryp_state_is_poolable(algo))
+		return NULL;
+
+	TAILQ_FOREACH(cs, &utc->cryp_pool, link) {
+		if (cs->algo == algo) {
+			TAILQ_REMOVE(&utc->cryp_pool, cs, link);
+			atomic_inc32(&cryp_pool_hits);
+			return cs;
+		}
+	}
+
+	atomic_inc32(&cryp_pool_misses);
+
+	return NULL;
+}
+
+/*
+ * Replace the key schedule held by the released context of @cs with the
+ * one of an all-zero key. Returns false if the context could not be reset,
+ * in which case it must not be pooled.
+ */
+static bool cryp_state_wipe(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
+{
+	struct tee_cryp_obj_secret *key = NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct tee_obj *o = NULL;
+	size_t key1_len = 0;
+	size_t key2_len = 0;
+	size_t iv_len = 0;
+	uint8_t *zero = NULL;
+
+	if (TEE_ALG_GET_CLASS(cs->algo) == TEE_OPERATION_DIGEST)
+		return crypto_hash_init(cs->ctx) == TEE_SUCCESS;
+
+	/* No key was ever set, the context holds no key material */
+	if (tee_obj_get(utc, cs->key1, &o) != TEE_SUCCESS)
+		return true;
+	key = o->attr;
+	key1_len = key->key_size;
+	if (tee_obj_get(utc, cs->key2, &o) == TEE_SUCCESS) {
+		key = o->attr;
+		key2_len = key->key_size;
+	}
+
+	zero = calloc(1, MAX(MAX(key1_len, key2_len), TEE_AES_BLOCK_SIZE));
+	if (!zero)
+		return false;
+
+	switch (TEE_ALG_GET_CLASS(cs->algo)) {
+	case TEE_OPERATION_CIPHER:
+		res = crypto_cipher_get_block_size(cs->algo, &iv_len);
+		if (res)
+			break;
+		res = crypto_cipher_init(cs->ctx, cs->mode, zero, key1_len,
+					 key2_len ? zero : NULL, key2_len,
+					 zero, iv_len);
+		if (!res)
+			crypto_cipher_final(cs->ctx);
+		break;
+	case TEE_OPERATION_AE:
+		/* Nonce and tag lengths valid for both GCM and CCM */
+		res = crypto_authenc_init(cs->ctx, cs->mode, zero, key1_len,
+					  zero, 12, TEE_AES_BLOCK_SIZE, 0, 0);
+		if (!res)
+			crypto_authenc_final(cs->ctx);
+		break;
+	case TEE_OPERATION_MAC:
+		res = crypto_mac_init(cs->ctx, zero, key1_len);
+		break;
+	default:
+		break;
+	}
+
+	free(zero);
+
+	return res == TEE_SUCCESS;
+}
+
+static bool cryp_pool_put(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
+{
+	struct tee_cryp_state *s = NULL;
+	size_t count = 0;
+
+	if (!cs->ctx || !cryp_state_is_poolable(cs->algo))
+		return false;
+
+	TAILQ_FOREACH(s, &utc->cryp_pool, link)
+		count++;
+	if (count >= CFG_CRYPTO_STATE_POOL_SIZE)
+		return false;
+
+	if (!cryp_state_wipe(utc, cs))
+		return false;
+
+	cs->mode = 0;
+	cs->key1 = 0;
+	cs->key2 = 0;
+	cs->ctx_finalize = NULL;
+	cs->state = CRYP_STATE_UNINITIALIZED;
+	TAILQ_INSERT_HEAD(&utc->cryp_pool, cs, link);
+
+	return true;
+}
+
+static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
+{
+	vaddr_t key1 = cs->key1;
+	vaddr_t key2 = cs->key2;
+	struct tee_obj *o;
+
+	TAILQ_REMOVE(&utc->cryp_states, cs, link);
+	if (cs->ctx_finalize != NULL)
+		cs->ctx_finalize(cs->ctx);
+
+	/* Key objects are closed last, pooling needs their sizes */
+	if (!cryp_pool_put(utc, cs))
+		cryp_state_free_ctx(cs);
+
+	if (tee_obj_get(utc, key1, &o) == TEE_SUCCESS)
+		tee_obj_close(utc, o);
+	if (tee_obj_get(utc, key2, &o) == TEE_SUCCESS)
+		tee_obj_close(utc, o);
+}
+
 static TEE_Result tee_svc_cryp_check_key_type(const struct tee_obj *o,
 					      uint32_t algo,
 					      TEE_OperationMode mode)
@@ -2801,9 +2959,12 @@ TEE_Result syscall_cryp_state_alloc(unsigned long algo, unsigned long mode,
 			return res;
 	}
 
-	cs = calloc(1, sizeof(struct tee_cryp_state));
-	if (!cs)
-		return TEE_ERROR_OUT_OF_MEMORY;
+	cs = cryp_pool_get(utc, algo);
+	if (!cs) {
+		cs = calloc(1, sizeof(struct tee_cryp_state));
+		if (!cs)
+			return TEE_ERROR_OUT_OF_MEMORY;
+	}
 	TAILQ_INSERT_TAIL(&utc->cryp_states, cs, link);
 	cs->algo = algo;
 	cs->mode = mode;
@@ -2816,37 +2977,29 @@ TEE_Result syscall_cryp_state_alloc(unsigned long algo, unsigned long mode,
 		    (TEE_ALG_GET_CHAIN_MODE(algo) != TEE_CHAIN_MODE_XTS &&
 		    (key1 == 0 || key2 != 0))) {
 			res = TEE_ERROR_BAD_PARAMETERS;
-		} else {
+		} else if (!cs->ctx) {
 			res = crypto_cipher_alloc_ctx(&cs->ctx, algo);
-			if (res != TEE_SUCCESS)
-				break;
 		}
 		break;
 	case TEE_OPERATION_AE:
 		if (key1 == 0 || key2 != 0) {
 			res = TEE_ERROR_BAD_PARAMETERS;
-		} else {
+		} else if (!cs->ctx) {
 			res = crypto_authenc_alloc_ctx(&cs->ctx, algo);
-			if (res != TEE_SUCCESS)
-				break;
 		}
 		break;
 	case TEE_OPERATION_MAC:
 		if (key1 == 0 || key2 != 0) {
 			res = TEE_ERROR_BAD_PARAMETERS;
-		} else {
+		} else if (!cs->ctx) {
 			res = crypto_mac_alloc_ctx(&cs->ctx, algo);
-			if (res != TEE_SUCCESS)
-				break;
 		}
 		break;
 	case TEE_OPERATION_DIGEST:
 		if (key1 != 0 || key2 != 0) {
 			res = TEE_ERROR_BAD_PARAMETERS;
-		} else {
+		} else if (!cs->ctx) {
 			res = crypto_hash_alloc_ctx(&cs->ctx, algo);
-			if (res != TEE_SUCCESS)
-				break;
 		}
 		break;
 	case TEE_OPERATION_ASYMMETRIC_CIPHER:
@@ -2938,9 +3091,16 @@ TEE_Result syscall_cryp_state_copy(unsigned long dst, unsigned long src)
 void tee_svc_cryp_free_states(struct user_ta_ctx *utc)
 {
 	struct tee_cryp_state_head *states = &utc->cryp_states;
+	struct tee_cryp_state *cs = NULL;
 
 	while (!TAILQ_EMPTY(states))
 		cryp_state_free(utc, TAILQ_FIRST(states));
+
+	while (!TAILQ_EMPTY(&utc->cryp_pool)) {
+		cs = TAILQ_FIRST(&utc->cryp_pool);
+		TAILQ_REMOVE(&utc->cryp_pool, cs, link);
+		cryp_state_free_ctx(cs);
+	}
 }
 
 TEE_Result syscall_cryp_state_free(unsigned long state)
@@ -108,6 +108,23 @@
  */
 #define PTA_INVOKE_TESTS_CMD_DT_DRIVER_TESTS	11
 
+/*
+ * AES GCM batch performance tests
+ *
+ * The in buffer is split in jobs of unit size bytes, each job is a
+ * complete GCM operation with its own nonce and a 16 bytes tag.
+ *
+ * [in]     value[0].a	Top 16 bits Decrypt, low 16 bits key size in bits
+ * [in]     value[0].b	One of PTA_INVOKE_TESTS_AES_GCM_{SINGLE,BATCH}
+ * [in]     value[1].a	repetition count
+ * [in]     value[1].b	unit size
+ * [in]     memref[2]	In buffer
+ * [in]     memref[3]	Out buffer
+ */
+#define PTA_INVOKE_TESTS_AES_GCM_SINGLE		0
+#define PTA_INVOKE_TESTS_AES_GCM_BATCH		1
+#define PTA_INVOKE_TESTS_CMD_AES_GCM_BATCH_PERF	12
+
 /*
  * Tests Mailbox  *
  * [in]  value[0].a	Test function PTA_MBOX_TEST_*
@@ -91,4 +91,39 @@ struct pta_stats_ta {
 #define STATS_DRIVER_TYPE_CLOCK		0
 #define STATS_DRIVER_TYPE_REGULATOR	1
 
+/*
+ * STATS_CMD_MUTEX_STATS - Get contention statistics of registered mutexes
+ *
+ * [in]     value[0].a        0 if no reset of the stats
+ * [out]    memref[1]         Array of struct pta_stats_mutex instances
+ *
+ * Return codes:
+ * TEE_SUCCESS - Invoke command success
+ * TEE_ERROR_SHORT_BUFFER - memref[1] too small, size updated
+ * TEE_ERROR_NOT_SUPPORTED - Mutex statistics not enabled (CFG_MUTEX_STATS)
+ */
+#define STATS_CMD_MUTEX_STATS		6
+
+#define TEE_MUTEX_DESC_LENGTH	32
+
+struct pta_stats_mutex {
+	char desc[TEE_MUTEX_DESC_LENGTH];
+	uint32_t locked;		/* Number of acquisitions */
+	uint32_t contended;		/* Acquisitions that found it held */
+	uint32_t spin_acquired;		/* Contended ones resolved spinning */
+	uint32_t sleeps;		/* Sleeps in normal world */
+	uint32_t max_spin_us;		/* Longest spin in microseconds */
+};
+
+/*
+ * STATS_CMD_CRYP_POOL_STATS - Get statistics on the TA crypto state pool
+ *
+ * [out]    value[0].a        Allocations served from the pool
+ * [out]    value[0].b        Allocations that found no state in the pool
+ *
+ * Return codes:
+ * TEE_SUCCESS - Invoke command success
+ */
+#define STATS_CMD_CRYP_POOL_STATS	7
+
 #endif /*__PTA_STATS_H*/
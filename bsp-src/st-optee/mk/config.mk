@@ -431,6 +431,18 @@ CFG_CORE_PAGE_TAG_AND_IV ?= $(CFG_PAGED_USER_TA)
 CFG_LOCKDEP ?= n
 CFG_LOCKDEP_RECORD_STACK ?= y
 
+# Adaptive mutexes: a contended mutex_lock() or mutex_read_lock() spins for
+# at most CFG_MUTEX_SPIN_US microseconds while the thread holding the write
+# lock is running on another core, before sleeping in normal world. This
+# saves an RPC round trip when the lock is held for a short time only.
+# 0 disables spinning.
+CFG_MUTEX_SPIN_US ?= 0
+
+# Collect contention statistics (acquisitions, spins, sleeps) for mutexes
+# registered with mutex_stats_register(). The statistics are reported by the
+# stats PTA command STATS_CMD_MUTEX_STATS.
+CFG_MUTEX_STATS ?= n
+
 # BestFit algorithm in bget reduces the fragmentation of the heap when running
 # with the pager enabled or lockdep
 CFG_CORE_BGET_BESTFIT ?= $(call cfg-one-enabled, CFG_WITH_PAGER CFG_LOCKDEP)
@@ -1121,6 +1133,13 @@ CFG_TA_OPTEE_CORE_API_COMPAT_1_1 ?= n
 # Note that this violates GP requirements of HMAC size range.
 CFG_HMAC_64_1024_RANGE ?= n
 
+# Number of released crypto operation states (cipher, AE, MAC and digest)
+# each user TA context keeps for reuse by later operation allocations of the
+# same algorithm. Saves context allocation and setup for TAs allocating many
+# short lived operations. Pooled contexts are reset with an all-zero key.
+# 0 disables the pool.
+CFG_CRYPTO_STATE_POOL_SIZE ?= 0
+
 # Enable a hardware pbkdf2 function
 # By default use standard pbkdf2 implementation
 CFG_CRYPTO_HW_PBKDF2 ?= n
@@ -305,6 +305,11 @@ enum pkcs11_ta_cmd {
 	 * [in]  memref[1] = input data to be processed
 	 * [out] memref[2] = output processed data
 	 *
+	 * For AES ECB and CBC mechanisms, data can alternatively be processed
+	 * in place to spare a second shared buffer for bulk data:
+	 * [inout] memref[1] = input data, overwritten with processed data
+	 * [none]  memref[2]
+	 *
 	 * These commands relate to the PKCS#11 API functions
 	 * C_EncryptUpdate() and C_DecryptUpdate().
 	 */
@@ -336,6 +341,9 @@ enum pkcs11_ta_cmd {
 	 * [in]  memref[1] = input data to be processed
 	 * [out] memref[2] = output processed data
 	 *
+	 * For AES ECB and CBC mechanisms, data can alternatively be processed
+	 * in place, as for PKCS11_CMD_ENCRYPT_UPDATE/PKCS11_CMD_DECRYPT_UPDATE.
+	 *
 	 * These commands relate to the PKCS#11 API functions C_Encrypt and
 	 * C_Decrypt.
 	 */
@@ -654,6 +662,11 @@ enum pkcs11_ta_cmd {
 	 * [in]  memref[1] = input data to be processed
 	 * [out] memref[2] = byte array: generated digest
 	 *
+	 * The digest can alternatively be returned in the input buffer to
+	 * spare a second shared buffer for bulk data:
+	 * [inout] memref[1] = input data, overwritten with generated digest
+	 * [none]  memref[2]
+	 *
 	 * This command relates to the PKCS#11 API function C_Digest().
 	 */
 	PKCS11_CMD_DIGEST_ONESHOT = 49,
@@ -270,6 +270,9 @@ enum pkcs11_rc create_object(void *sess, struct obj_attrs *head,
 		if (rc)
 			goto err;
 
+		set_persistent_object_index(obj);
+		save_persistent_index(get_session_token(session));
+
 		TEE_CloseObject(obj->attribs_hdl);
 		obj->attribs_hdl = TEE_HANDLE_NULL;
 
@@ -504,6 +507,8 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 	struct pkcs11_object *obj = NULL;
 	struct pkcs11_find_objects *find_ctx = NULL;
 	struct handle_db *object_db = NULL;
+	struct pkcs11_object_index ref_index = { };
+	bool index_updated = false;
 
 	if (!client || ptypes != exp_pt)
 		return PKCS11_CKR_ARGUMENTS_BAD;
@@ -597,12 +602,21 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 
 	object_db = get_object_handle_db(session);
 
+	/*
+	 * Token objects which search index does not match the template are
+	 * skipped without loading their attributes from secure storage.
+	 */
+	get_object_index(req_attrs, &ref_index);
+
 	/* Scan token objects */
 	LIST_FOREACH(obj, &session->token->object_list, link) {
 		uint32_t handle = 0;
 		bool new_load = false;
 
 		if (!obj->attributes) {
+			if (!object_index_may_match(&obj->index, &ref_index))
+				continue;
+
 			rc = load_persistent_object_attributes(obj);
 			if (rc) {
 				rc = PKCS11_CKR_GENERAL_ERROR;
@@ -610,6 +624,11 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 			}
 
 			new_load = true;
+
+			if (!(obj->index.flags & PKCS11_OBJ_INDEX_VALID)) {
+				set_persistent_object_index(obj);
+				index_updated = true;
+			}
 		}
 
 		if (!obj->attributes ||
@@ -644,6 +663,9 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 	rc = PKCS11_CKR_OK;
 
 out:
+	if (index_updated)
+		save_persistent_index(session->token);
+
 	TEE_Free(req_attrs);
 	TEE_Free(template);
 	release_find_obj_context(find_ctx);
@@ -1065,9 +1087,22 @@ enum pkcs11_rc entry_set_attribute_value(struct pkcs11_client *client,
 		goto out;
 
 	if (get_bool(obj->attributes, PKCS11_CKA_TOKEN)) {
+		/*
+		 * Invalidate the saved search index entry of the object before
+		 * rewriting it: a reset before the new entry is saved must not
+		 * leave an entry hiding the object from searches.
+		 */
+		clear_persistent_object_index(obj);
+		rc = save_persistent_index(obj->token);
+		if (rc)
+			goto out;
+
 		rc = update_persistent_object_attributes(obj);
 		if (rc)
 			goto out;
+
+		set_persistent_object_index(obj);
+		save_persistent_index(obj->token);
 	}
 
 	DMSG("PKCS11 session %"PRIu32": set attributes %#"PRIx32,
@@ -9,12 +9,35 @@
 #include <pkcs11_ta.h>
 #include <sys/queue.h>
 #include <tee_internal_api.h>
+#include <util.h>
 
 struct ck_token;
 struct obj_attrs;
 struct pkcs11_client;
 struct pkcs11_session;
 
+#define PKCS11_OBJ_INDEX_VALID		BIT(0)
+#define PKCS11_OBJ_INDEX_HAS_ID		BIT(1)
+#define PKCS11_OBJ_INDEX_HAS_LABEL	BIT(2)
+
+/*
+ * Search index of an object, used to skip objects that cannot match an
+ * object search template without loading their attributes
+ *
+ * @flags - PKCS11_OBJ_INDEX_* bit flags
+ * @class - CKA_CLASS value or PKCS11_CKO_UNDEFINED_ID
+ * @key_type - CKA_KEY_TYPE value or PKCS11_CKK_UNDEFINED_ID
+ * @id_hash - hash of CKA_ID value if PKCS11_OBJ_INDEX_HAS_ID is set
+ * @label_hash - hash of CKA_LABEL value if PKCS11_OBJ_INDEX_HAS_LABEL is set
+ */
+struct pkcs11_object_index {
+	uint32_t flags;
+	uint32_t class;
+	uint32_t key_type;
+	uint32_t id_hash;
+	uint32_t label_hash;
+};
+
 /*
  * link: objects are referenced in a double-linked list
  * attributes: pointer to the serialized object attributes
@@ -23,6 +46,7 @@ struct pkcs11_session;
  * token: associated token for the object
  * uuid: object UUID in the persistent database if a persistent object, or NULL
  * attribs_hdl: GPD TEE attributes handles if persistent object
+ * index: search index if persistent object
  */
 struct pkcs11_object {
 	LIST_ENTRY(pkcs11_object) link;
@@ -32,6 +56,7 @@ struct pkcs11_object {
 	struct ck_token *token;
 	TEE_UUID *uuid;
 	TEE_ObjectHandle attribs_hdl;
+	struct pkcs11_object_index index;
 };
 
 LIST_HEAD(object_list, pkcs11_object);
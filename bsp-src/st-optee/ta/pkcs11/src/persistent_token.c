@@ -51,6 +51,216 @@ static TEE_Result open_db_file(struct ck_token *token,
 					out_hdl);
 }
 
+/*
+ * Token persistent search index
+ *
+ * For each persistent object, the index stores the attributes most commonly
+ * used as object search criteria (CKA_CLASS, CKA_KEY_TYPE, CKA_ID and
+ * CKA_LABEL) so that C_FindObjectsInit() can skip objects without loading
+ * their attributes from secure storage. CKA_ID and CKA_LABEL are stored as
+ * hashes hence an index match is only a hint: candidate objects are still
+ * matched against their full attributes.
+ *
+ * The index is stored in its own file so that a missing, outdated or
+ * corrupted index only disables the shortcut for the related objects. Their
+ * index is rebuilt when their attributes get loaded.
+ */
+static TEE_Result get_index_file_name(struct ck_token *token,
+				      char *name, size_t size)
+{
+	int n = snprintf(name, size, "token.idx.%u", get_token_id(token));
+
+	if (n < 0 || (size_t)n >= size)
+		return TEE_ERROR_SECURITY;
+	else
+		return TEE_SUCCESS;
+}
+
+static size_t index_size(uint32_t count)
+{
+	return sizeof(struct token_persistent_index) +
+	       count * sizeof(struct token_persistent_index_entry);
+}
+
+/* FNV-1a hash of an attribute value */
+static uint32_t hash_attribute_value(const uint8_t *data, size_t size)
+{
+	uint32_t hash = 0x811c9dc5;
+	size_t n = 0;
+
+	for (n = 0; n < size; n++) {
+		hash ^= data[n];
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+void get_object_index(struct obj_attrs *attrs,
+		      struct pkcs11_object_index *index)
+{
+	void *value = NULL;
+	uint32_t size = 0;
+
+	TEE_MemFill(index, 0, sizeof(*index));
+
+	index->flags = PKCS11_OBJ_INDEX_VALID;
+	index->class = get_class(attrs);
+	index->key_type = get_key_type(attrs);
+
+	if (get_attribute_ptr(attrs, PKCS11_CKA_ID, &value, &size) ==
+	    PKCS11_CKR_OK) {
+		index->flags |= PKCS11_OBJ_INDEX_HAS_ID;
+		index->id_hash = hash_attribute_value(value, size);
+	}
+
+	if (get_attribute_ptr(attrs, PKCS11_CKA_LABEL, &value, &size) ==
+	    PKCS11_CKR_OK) {
+		index->flags |= PKCS11_OBJ_INDEX_HAS_LABEL;
+		index->label_hash = hash_attribute_value(value, size);
+	}
+}
+
+/*
+ * Return false if an object of search index @index cannot match a search
+ * template of index @ref. Return true if the object may match, including
+ * when the object has no valid index.
+ */
+bool object_index_may_match(struct pkcs11_object_index *index,
+			    struct pkcs11_object_index *ref)
+{
+	if (!(index->flags & PKCS11_OBJ_INDEX_VALID))
+		return true;
+
+	if (ref->class != PKCS11_CKO_UNDEFINED_ID &&
+	    ref->class != index->class)
+		return false;
+
+	if (ref->key_type != PKCS11_CKK_UNDEFINED_ID &&
+	    ref->key_type != index->key_type)
+		return false;
+
+	if ((ref->flags & PKCS11_OBJ_INDEX_HAS_ID) &&
+	    (!(index->flags & PKCS11_OBJ_INDEX_HAS_ID) ||
+	     ref->id_hash != index->id_hash))
+		return false;
+
+	if ((ref->flags & PKCS11_OBJ_INDEX_HAS_LABEL) &&
+	    (!(index->flags & PKCS11_OBJ_INDEX_HAS_LABEL) ||
+	     ref->label_hash != index->label_hash))
+		return false;
+
+	return true;
+}
+
+/*
+ * Load the search index of the token. Entries that do not relate to the
+ * object referenced at the same position in the object database are
+ * discarded. On error, the token runs without a search index.
+ */
+static void load_persistent_index(struct ck_token *token)
+{
+	char file[PERSISTENT_OBJECT_ID_LEN] = { };
+	struct token_persistent_index head = { };
+	struct token_persistent_index *index = NULL;
+	TEE_ObjectHandle hdl = TEE_HANDLE_NULL;
+	uint32_t count = token->db_objs->count;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	size_t size = 0;
+	size_t n = 0;
+
+	index = TEE_Malloc(index_size(count), TEE_MALLOC_FILL_ZERO);
+	if (!index) {
+		EMSG("PKCS11 token %u: no memory for search index",
+		     get_token_id(token));
+		return;
+	}
+
+	index->version = PKCS11_TOKEN_INDEX_VERSION;
+	index->count = count;
+	for (n = 0; n < count; n++)
+		index->entries[n].uuid = token->db_objs->uuids[n];
+	token->db_index = index;
+
+	if (get_index_file_name(token, file, sizeof(file)))
+		return;
+
+	res = TEE_OpenPersistentObject(TEE_STORAGE_PRIVATE, file, sizeof(file),
+				       TEE_DATA_FLAG_ACCESS_READ, &hdl);
+	if (res)
+		return;
+
+	size = sizeof(head);
+	res = TEE_ReadObjectData(hdl, &head, size, &size);
+	if (res || size != sizeof(head) ||
+	    head.version != PKCS11_TOKEN_INDEX_VERSION || head.count != count) {
+		DMSG("PKCS11 token %u: discard outdated search index",
+		     get_token_id(token));
+		goto out;
+	}
+
+	for (n = 0; n < count; n++) {
+		struct token_persistent_index_entry entry = { };
+
+		size = sizeof(entry);
+		res = TEE_ReadObjectData(hdl, &entry, size, &size);
+		if (res || size != sizeof(entry))
+			break;
+
+		if (!TEE_MemCompare(&entry.uuid, &token->db_objs->uuids[n],
+				    sizeof(TEE_UUID)))
+			index->entries[n].index = entry.index;
+	}
+
+out:
+	TEE_CloseObject(hdl);
+}
+
+enum pkcs11_rc save_persistent_index(struct ck_token *token)
+{
+	char file[PERSISTENT_OBJECT_ID_LEN] = { };
+	TEE_ObjectHandle hdl = TEE_HANDLE_NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	if (!token->db_index)
+		return PKCS11_CKR_OK;
+
+	if (get_index_file_name(token, file, sizeof(file)))
+		return PKCS11_CKR_GENERAL_ERROR;
+
+	/*
+	 * An index outdated by objects being created or destroyed is detected
+	 * and discarded when loaded.
+	 */
+	res = TEE_CreatePersistentObject(TEE_STORAGE_PRIVATE,
+					 file, sizeof(file),
+					 TEE_DATA_FLAG_ACCESS_READ |
+					 TEE_DATA_FLAG_ACCESS_WRITE |
+					 TEE_DATA_FLAG_OVERWRITE,
+					 TEE_HANDLE_NULL, token->db_index,
+					 index_size(token->db_index->count),
+					 &hdl);
+	if (res) {
+		EMSG("Failed to save token search index: %#"PRIx32, res);
+
+		/*
+		 * The previous index may not match modified objects anymore:
+		 * remove it so that the token runs without a search index.
+		 */
+		if (!TEE_OpenPersistentObject(TEE_STORAGE_PRIVATE,
+					      file, sizeof(file),
+					      TEE_DATA_FLAG_ACCESS_WRITE_META,
+					      &hdl))
+			TEE_CloseAndDeletePersistentObject1(hdl);
+
+		return tee2pkcs_error(res);
+	}
+
+	TEE_CloseObject(hdl);
+
+	return PKCS11_CKR_OK;
+}
+
 void update_persistent_db(struct ck_token *token)
 {
 	TEE_Result res = TEE_ERROR_GENERIC;
@@ -305,6 +515,34 @@ static int get_persistent_obj_idx(struct ck_token *token, TEE_UUID *uuid)
 	return -1;
 }
 
+/* Copy the search index of @obj into the token search index */
+static void store_persistent_object_index(struct pkcs11_object *obj)
+{
+	struct ck_token *token = obj->token;
+	int idx = 0;
+
+	if (!token || !token->db_index)
+		return;
+
+	idx = get_persistent_obj_idx(token, obj->uuid);
+	if (idx >= 0)
+		token->db_index->entries[idx].index = obj->index;
+}
+
+void set_persistent_object_index(struct pkcs11_object *obj)
+{
+	assert(obj->attributes);
+
+	get_object_index(obj->attributes, &obj->index);
+	store_persistent_object_index(obj);
+}
+
+void clear_persistent_object_index(struct pkcs11_object *obj)
+{
+	TEE_MemFill(&obj->index, 0, sizeof(obj->index));
+	store_persistent_object_index(obj);
+}
+
 /* UUID for persistent object */
 enum pkcs11_rc create_object_uuid(struct ck_token *token,
 				  struct pkcs11_object *obj)
@@ -405,6 +643,15 @@ enum pkcs11_rc unregister_persistent_object(struct ck_token *token,
 	token->db_objs = ptr;
 	ptr = NULL;
 
+	if (token->db_index) {
+		struct token_persistent_index *index = token->db_index;
+
+		index->count--;
+		TEE_MemMove(&index->entries[idx], &index->entries[idx + 1],
+			    (index->count - idx) * sizeof(index->entries[0]));
+		save_persistent_index(token);
+	}
+
 out:
 	TEE_CloseObject(db_hdl);
 	TEE_Free(ptr);
@@ -456,8 +703,26 @@ enum pkcs11_rc register_persistent_object(struct ck_token *token,
 	res = TEE_WriteObjectData(db_hdl, token->db_objs,
 				  sizeof(struct token_persistent_objs) +
 				  token->db_objs->count * sizeof(TEE_UUID));
-	if (res)
+	if (res) {
 		token->db_objs->count--;
+		goto out;
+	}
+
+	if (token->db_index) {
+		ptr = TEE_Realloc(token->db_index,
+				  index_size(token->db_index->count + 1));
+		if (ptr) {
+			token->db_index = ptr;
+			token->db_index->entries[count].uuid = *uuid;
+			TEE_MemFill(&token->db_index->entries[count].index, 0,
+				    sizeof(struct pkcs11_object_index));
+			token->db_index->count++;
+		} else {
+			/* Run without index rather than with a wrong one */
+			TEE_Free(token->db_index);
+			token->db_index = NULL;
+		}
+	}
 
 out:
 	TEE_CloseObject(db_hdl);
@@ -627,6 +892,9 @@ struct ck_token *init_persistent_db(unsigned int token_id)
 				TEE_Panic(0);
 		}
 
+		token->db_objs = db_objs;
+		load_persistent_index(token);
+
 		for (idx = 0; idx < db_objs->count; idx++) {
 			/* Create an empty object instance */
 			struct pkcs11_object *obj = NULL;
@@ -643,6 +911,9 @@ struct ck_token *init_persistent_db(unsigned int token_id)
 			if (!obj)
 				TEE_Panic(0);
 
+			if (token->db_index)
+				obj->index = token->db_index->entries[idx].index;
+
 			LIST_INSERT_HEAD(&token->object_list, obj, link);
 		}
 
@@ -694,6 +965,9 @@ struct ck_token *init_persistent_db(unsigned int token_id)
 		if (res)
 			TEE_Panic(0);
 
+		token->db_objs = db_objs;
+		load_persistent_index(token);
+
 	} else {
 		goto error;
 	}
@@ -707,6 +981,9 @@ struct ck_token *init_persistent_db(unsigned int token_id)
 error:
 	TEE_Free(db_main);
 	TEE_Free(db_objs);
+	TEE_Free(token->db_index);
+	token->db_objs = NULL;
+	token->db_index = NULL;
 	if (db_hdl != TEE_HANDLE_NULL)
 		TEE_CloseObject(db_hdl);
 
@@ -86,6 +86,27 @@ struct token_persistent_objs {
 	TEE_UUID uuids[];
 };
 
+/*
+ * Persistent search index of the objects in the token
+ *
+ * @version - PKCS11_TOKEN_INDEX_VERSION
+ * @count - number of entries, equals the number of objects in the token
+ * @entries - object UUID and index, in the order of struct
+ *	token_persistent_objs UUIDs (@count items)
+ */
+#define PKCS11_TOKEN_INDEX_VERSION	1
+
+struct token_persistent_index_entry {
+	TEE_UUID uuid;
+	struct pkcs11_object_index index;
+};
+
+struct token_persistent_index {
+	uint32_t version;
+	uint32_t count;
+	struct token_persistent_index_entry entries[];
+};
+
 /*
  * Runtime state of the token, complies with pkcs11
  *
@@ -95,6 +116,7 @@ struct token_persistent_objs {
  * @object_list - List of the objects owned by the token
  * @db_main - Volatile copy of the persistent main database
  * @db_objs - Volatile copy of the persistent object database
+ * @db_index - Volatile copy of the persistent search index or NULL
  */
 struct ck_token {
 	enum pkcs11_token_state state;
@@ -104,6 +126,7 @@ struct ck_token {
 	/* Copy in RAM of the persistent database */
 	struct token_persistent_main *db_main;
 	struct token_persistent_objs *db_objs;
+	struct token_persistent_index *db_index;
 };
 
 /*
@@ -215,6 +238,15 @@ enum pkcs11_rc load_persistent_object_attributes(struct pkcs11_object *obj);
 void release_persistent_object_attributes(struct pkcs11_object *obj);
 enum pkcs11_rc update_persistent_object_attributes(struct pkcs11_object *obj);
 
+/* Search index of objects */
+void get_object_index(struct obj_attrs *attrs,
+		      struct pkcs11_object_index *index);
+bool object_index_may_match(struct pkcs11_object_index *index,
+			    struct pkcs11_object_index *ref);
+void set_persistent_object_index(struct pkcs11_object *obj);
+void clear_persistent_object_index(struct pkcs11_object *obj);
+enum pkcs11_rc save_persistent_index(struct ck_token *token);
+
 enum pkcs11_rc hash_pin(enum pkcs11_user_type user, const uint8_t *pin,
 			size_t pin_size, uint32_t *salt,
 			uint8_t hash[TEE_MAX_HASH_SIZE]);
@@ -123,6 +123,7 @@ enum pkcs11_rc step_digest_operation(struct pkcs11_session *session,
 	uint32_t secret_value_size = 0;
 	enum pkcs11_key_type key_type = PKCS11_CKK_UNDEFINED_ID;
 	struct active_processing *proc = session->processing;
+	bool in_place = false;
 
 	if (TEE_PARAM_TYPE_GET(ptypes, 1) == TEE_PARAM_TYPE_MEMREF_INPUT) {
 		in_buf = params[1].memref.buffer;
@@ -130,6 +131,25 @@ enum pkcs11_rc step_digest_operation(struct pkcs11_session *session,
 		if (in_size && !in_buf)
 			return PKCS11_CKR_ARGUMENTS_BAD;
 	}
+	/*
+	 * A one-shot digest can be returned in the input buffer: the TEE
+	 * checks the output size before it consumes any data and writes the
+	 * digest only once all data has been hashed.
+	 */
+	if (TEE_PARAM_TYPE_GET(ptypes, 1) == TEE_PARAM_TYPE_MEMREF_INOUT) {
+		if (step != PKCS11_FUNC_STEP_ONESHOT ||
+		    TEE_PARAM_TYPE_GET(ptypes, 2) != TEE_PARAM_TYPE_NONE)
+			return PKCS11_CKR_ARGUMENTS_BAD;
+
+		in_buf = params[1].memref.buffer;
+		in_size = params[1].memref.size;
+		if (in_size && !in_buf)
+			return PKCS11_CKR_ARGUMENTS_BAD;
+
+		out_buf = in_buf;
+		out_size = in_size;
+		in_place = true;
+	}
 	if (TEE_PARAM_TYPE_GET(ptypes, 2) == TEE_PARAM_TYPE_MEMREF_OUTPUT) {
 		out_buf = params[2].memref.buffer;
 		out_size = params[2].memref.size;
@@ -213,7 +233,7 @@ do_final:
 	rc = tee2pkcs_error(res);
 
 	if (rc == PKCS11_CKR_OK || rc == PKCS11_CKR_BUFFER_TOO_SMALL)
-		params[2].memref.size = out_size;
+		params[in_place ? 1 : 2].memref.size = out_size;
 
 	return rc;
 }
@@ -661,6 +661,33 @@ static enum pkcs11_rc input_data_size_is_valid(struct active_processing *proc,
 	return PKCS11_CKR_OK;
 }
 
+/*
+ * In-place processing reuses the input memref as output buffer, sparing
+ * the client a second shared buffer for bulk data. It is only possible
+ * when the TEE cipher operation outputs exactly the data it consumes in
+ * each update, that is, for block aligned modes without buffering.
+ */
+static bool processing_can_be_in_place(struct active_processing *proc,
+				       enum processing_func function,
+				       enum processing_step step)
+{
+	if (function != PKCS11_FUNCTION_ENCRYPT &&
+	    function != PKCS11_FUNCTION_DECRYPT)
+		return false;
+
+	if (step != PKCS11_FUNC_STEP_UPDATE &&
+	    step != PKCS11_FUNC_STEP_ONESHOT)
+		return false;
+
+	switch (proc->mecha_type) {
+	case PKCS11_CKM_AES_ECB:
+	case PKCS11_CKM_AES_CBC:
+		return true;
+	default:
+		return false;
+	}
+}
+
 /* Validate input buffer size as per PKCS#11 constraints */
 static enum pkcs11_rc input_sign_size_is_valid(struct active_processing *proc,
 					       size_t in_size)
@@ -726,6 +753,7 @@ enum pkcs11_rc step_symm_operation(struct pkcs11_session *session,
 	uint32_t hmac_len = 0;
 	uint8_t computed_mac[TEE_MAX_HASH_SIZE] = { 0 };
 	size_t computed_mac_size = TEE_MAX_HASH_SIZE;
+	bool in_place = false;
 
 	if (TEE_PARAM_TYPE_GET(ptypes, 1) == TEE_PARAM_TYPE_MEMREF_INPUT) {
 		in_buf = params[1].memref.buffer;
@@ -733,6 +761,20 @@ enum pkcs11_rc step_symm_operation(struct pkcs11_session *session,
 		if (in_size && !in_buf)
 			return PKCS11_CKR_ARGUMENTS_BAD;
 	}
+	if (TEE_PARAM_TYPE_GET(ptypes, 1) == TEE_PARAM_TYPE_MEMREF_INOUT) {
+		if (TEE_PARAM_TYPE_GET(ptypes, 2) != TEE_PARAM_TYPE_NONE ||
+		    !processing_can_be_in_place(proc, function, step))
+			return PKCS11_CKR_ARGUMENTS_BAD;
+
+		in_buf = params[1].memref.buffer;
+		in_size = params[1].memref.size;
+		if (in_size && !in_buf)
+			return PKCS11_CKR_ARGUMENTS_BAD;
+
+		out_buf = in_buf;
+		out_size = in_size;
+		in_place = true;
+	}
 	if (TEE_PARAM_TYPE_GET(ptypes, 2) == TEE_PARAM_TYPE_MEMREF_INPUT) {
 		in2_buf = params[2].memref.buffer;
 		in2_size = params[2].memref.size;
@@ -969,8 +1011,11 @@ enum pkcs11_rc step_symm_operation(struct pkcs11_session *session,
 	}
 
 out:
-	if (output_data &&
+	if (output_data && in_place &&
 	    (rc == PKCS11_CKR_OK || rc == PKCS11_CKR_BUFFER_TOO_SMALL)) {
+		params[1].memref.size = out_size;
+	} else if (output_data &&
+		   (rc == PKCS11_CKR_OK || rc == PKCS11_CKR_BUFFER_TOO_SMALL)) {
 		switch (TEE_PARAM_TYPE_GET(ptypes, 2)) {
 		case TEE_PARAM_TYPE_MEMREF_OUTPUT:
 		case TEE_PARAM_TYPE_MEMREF_INOUT:
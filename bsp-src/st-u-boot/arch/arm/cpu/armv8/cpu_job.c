@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (C) 2024, STMicroelectronics - All Rights Reserved
+ *
+ * Run a job on a secondary CPU, powered on with PSCI CPU_ON and sharing the
+ * translation tables of the boot CPU.
+ */
+
+#include <common.h>
+#include <cpu_func.h>
+#include <cpu_job.h>
+#include <dm.h>
+#include <malloc.h>
+#include <time.h>
+#include <watchdog.h>
+#include <asm/global_data.h>
+#include <asm/system.h>
+#include <dm/ofnode.h>
+#include <linux/psci.h>
+#include "cpu_job.h"
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define CPU_JOB_STACK_SIZE	SZ_64K
+#define CPU_JOB_OFF_TIMEOUT_MS	100
+
+struct cpu_job_ctx {
+	u64 mair;
+	u64 tcr;
+	u64 ttbr;
+	u64 sctlr;
+	u64 vbar;
+	u64 cptr;
+	u64 sp;
+	u64 gd;
+	u64 fn;
+	u64 arg;
+	u64 smc;
+	u64 done;
+} __aligned(ARCH_DMA_MINALIGN);
+
+_Static_assert(offsetof(struct cpu_job_ctx, done) == CPU_JOB_DONE,
+	       "cpu_job_ctx does not match cpu_job_entry.S");
+
+void cpu_job_entry(struct cpu_job_ctx *ctx);
+
+static struct cpu_job_ctx *cpu_job_ctx;
+static void *cpu_job_stack;
+static u64 cpu_job_mpidr;
+
+/* Find a CPU which is not the boot CPU */
+static int cpu_job_find_cpu(u64 *mpidr)
+{
+	u64 self = read_mpidr() & 0xff00ffffffUL;
+	ofnode cpus, node;
+	const char *type;
+	u32 reg;
+
+	cpus = ofnode_path("/cpus");
+	if (!ofnode_valid(cpus))
+		return -ENODEV;
+
+	ofnode_for_each_subnode(node, cpus) {
+		type = ofnode_read_string(node, "device_type");
+		if (!type || strcmp(type, "cpu"))
+			continue;
+		if (!ofnode_is_enabled(node) || ofnode_read_u32(node, "reg", &reg))
+			continue;
+		if (reg != self) {
+			*mpidr = reg;
+			return 0;
+		}
+	}
+
+	return -ENODEV;
+}
+
+static int cpu_job_init(void)
+{
+	struct udevice *dev;
+	const char *method;
+	int ret;
+
+	ret = cpu_job_find_cpu(&cpu_job_mpidr);
+	if (ret)
+		return -ENOSYS;
+
+	/* Probing the PSCI driver selects the conduit of invoke_psci_fn() */
+	ret = uclass_get_device_by_name(UCLASS_FIRMWARE, "psci", &dev);
+	if (ret)
+		return -ENOSYS;
+
+	cpu_job_ctx = memalign(ARCH_DMA_MINALIGN, sizeof(*cpu_job_ctx));
+	cpu_job_stack = memalign(16, CPU_JOB_STACK_SIZE);
+	if (!cpu_job_ctx || !cpu_job_stack) {
+		free(cpu_job_ctx);
+		free(cpu_job_stack);
+		cpu_job_ctx = NULL;
+		cpu_job_stack = NULL;
+		return -ENOMEM;
+	}
+
+	method = dev_read_string(dev, "method");
+	cpu_job_ctx->smc = method && !strcmp(method, "smc");
+
+	return 0;
+}
+
+int cpu_job_start(void (*fn)(void *arg), void *arg)
+{
+	struct cpu_job_ctx *ctx;
+	unsigned long ret;
+
+	/* The secondary CPU relies on coherent caches to share data */
+	if (!dcache_status())
+		return -ENOSYS;
+
+	/*
+	 * CPU_ON starts the secondary CPU at the highest non-secure EL, which
+	 * is EL2: it can only take over the translation regime of the boot CPU
+	 * when U-Boot runs at EL2 too.
+	 */
+	if (current_el() != 2)
+		return -ENOSYS;
+
+	if (!cpu_job_ctx) {
+		ret = cpu_job_init();
+		if (ret)
+			return ret;
+	}
+	ctx = cpu_job_ctx;
+
+	ret = invoke_psci_fn(PSCI_0_2_FN64_AFFINITY_INFO, cpu_job_mpidr, 0, 0);
+	if (ret != PSCI_0_2_AFFINITY_LEVEL_OFF)
+		return -EBUSY;
+
+	asm volatile("mrs %0, mair_el2" : "=r" (ctx->mair));
+	asm volatile("mrs %0, tcr_el2" : "=r" (ctx->tcr));
+	asm volatile("mrs %0, ttbr0_el2" : "=r" (ctx->ttbr));
+	asm volatile("mrs %0, vbar_el2" : "=r" (ctx->vbar));
+	asm volatile("mrs %0, cptr_el2" : "=r" (ctx->cptr));
+	ctx->sctlr = get_sctlr();
+	ctx->sp = (ulong)cpu_job_stack + CPU_JOB_STACK_SIZE;
+	ctx->gd = (ulong)gd;
+	ctx->fn = (ulong)fn;
+	ctx->arg = (ulong)arg;
+	ctx->done = 0;
+
+	/* The context is read with the MMU off */
+	flush_dcache_range((ulong)ctx, (ulong)ctx + sizeof(*ctx));
+
+	ret = invoke_psci_fn(PSCI_0_2_FN64_CPU_ON, cpu_job_mpidr,
+			     (ulong)cpu_job_entry, (ulong)ctx);
+	if (ret != PSCI_RET_SUCCESS) {
+		debug("%s: CPU_ON failed: %ld\n", __func__, (long)ret);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+int cpu_job_wait(void)
+{
+	struct cpu_job_ctx *ctx = cpu_job_ctx;
+	ulong start;
+
+	if (!ctx)
+		return -EINVAL;
+
+	while (!READ_ONCE(ctx->done))
+		schedule();
+
+	/* Pairs with the release of 'done': read the job results after it */
+	dmb();
+
+	/*
+	 * Let the CPU reach CPU_OFF before a new job is started. The job is
+	 * complete anyway: if the CPU is slow to power off, the next
+	 * cpu_job_start() finds it busy and the caller runs the job itself.
+	 */
+	start = get_timer(0);
+	while (invoke_psci_fn(PSCI_0_2_FN64_AFFINITY_INFO, cpu_job_mpidr, 0, 0) !=
+	       PSCI_0_2_AFFINITY_LEVEL_OFF) {
+		if (get_timer(start) > CPU_JOB_OFF_TIMEOUT_MS) {
+			debug("%s: CPU still on after the job\n", __func__);
+			break;
+		}
+	}
+
+	return 0;
+}
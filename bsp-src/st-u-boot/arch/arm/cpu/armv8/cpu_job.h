@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Copyright (C) 2024, STMicroelectronics - All Rights Reserved
+ */
+
+#ifndef __ARMV8_CPU_JOB_H
+#define __ARMV8_CPU_JOB_H
+
+/* Offsets in struct cpu_job_ctx, shared with cpu_job_entry.S */
+#define CPU_JOB_MAIR	0
+#define CPU_JOB_TCR	8
+#define CPU_JOB_TTBR	16
+#define CPU_JOB_SCTLR	24
+#define CPU_JOB_VBAR	32
+#define CPU_JOB_CPTR	40
+#define CPU_JOB_SP	48
+#define CPU_JOB_GD	56
+#define CPU_JOB_FN	64
+#define CPU_JOB_ARG	72
+#define CPU_JOB_SMC	80
+#define CPU_JOB_DONE	88
+
+#endif /* __ARMV8_CPU_JOB_H */
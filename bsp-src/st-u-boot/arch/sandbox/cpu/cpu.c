@@ -8,6 +8,7 @@
 #include <common.h>
 #include <bootstage.h>
 #include <cpu_func.h>
+#include <cpu_job.h>
 #include <errno.h>
 #include <log.h>
 #include <os.h>
@@ -406,3 +407,15 @@ int sandbox_load_other_fdt(void **fdtp, int *sizep)
 
 	return 0;
 }
+
+#if CONFIG_IS_ENABLED(CPU_JOB)
+int cpu_job_start(void (*fn)(void *arg), void *arg)
+{
+	return os_job_start(fn, arg) ? -EBUSY : 0;
+}
+
+int cpu_job_wait(void)
+{
+	return os_job_wait() ? -EINVAL : 0;
+}
+#endif
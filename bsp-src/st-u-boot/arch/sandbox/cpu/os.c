@@ -1060,6 +1060,45 @@ void os_relaunch(char *argv[])
 	os_exit(1);
 }
 
+static struct {
+	void (*fn)(void *arg);
+	void *arg;
+	pthread_t tid;
+	bool running;
+} os_job;
+
+static void *os_job_thread(void *ptr)
+{
+	os_job.fn(os_job.arg);
+
+	return NULL;
+}
+
+int os_job_start(void (*fn)(void *arg), void *arg)
+{
+	if (os_job.running)
+		return -1;
+
+	os_job.fn = fn;
+	os_job.arg = arg;
+	if (pthread_create(&os_job.tid, NULL, os_job_thread, NULL))
+		return -1;
+	os_job.running = true;
+
+	return 0;
+}
+
+int os_job_wait(void)
+{
+	if (!os_job.running)
+		return -1;
+
+	os_job.running = false;
+	if (pthread_join(os_job.tid, NULL))
+		return -1;
+
+	return 0;
+}
 
 #ifdef CONFIG_FUZZ
 static void *fuzzer_thread(void * ptr)
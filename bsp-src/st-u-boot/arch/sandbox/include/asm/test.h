@@ -150,6 +150,17 @@ int sandbox_pwm_get_config(struct udevice *dev, uint channel, uint *period_nsp,
  */
 void sandbox_sf_set_block_protect(struct udevice *dev, int bp_mask);
 
+/**
+ * sandbox_mmc_set_async_errors() - Make asynchronous MMC transfers fail
+ *
+ * The next @count transfers started with send_cmd_start() fail when they are
+ * polled. Synchronous commands are not affected.
+ *
+ * @dev: MMC device to update
+ * @count: Number of transfers to fail
+ */
+void sandbox_mmc_set_async_errors(struct udevice *dev, int count);
+
 /**
  * sandbox_get_codec_params() - Read back codec parameters
  *
@@ -14,6 +14,8 @@
 #include <part.h>
 #include <sparse_format.h>
 #include <image-sparse.h>
+#include <time.h>
+#include <linux/math64.h>
 
 static int curr_device = -1;
 
@@ -371,6 +373,66 @@ static int do_mmc_read(struct cmd_tbl *cmdtp, int flag,
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
 }
 
+#if CONFIG_IS_ENABLED(CMD_MMC_BENCH)
+static int do_mmc_bench(struct cmd_tbl *cmdtp, int flag,
+			int argc, char *const argv[])
+{
+	struct blk_desc *dev_desc;
+	struct mmc *mmc;
+	u32 blk, cnt, n;
+	u64 bytes, start, us;
+	bool write;
+	void *addr;
+
+	if (argc != 5)
+		return CMD_RET_USAGE;
+
+	if (!strcmp(argv[1], "read"))
+		write = false;
+	else if (CONFIG_IS_ENABLED(MMC_WRITE) && !strcmp(argv[1], "write"))
+		write = true;
+	else
+		return CMD_RET_USAGE;
+
+	addr = (void *)hextoul(argv[2], NULL);
+	blk = hextoul(argv[3], NULL);
+	cnt = hextoul(argv[4], NULL);
+
+	mmc = init_mmc_device(curr_device, false);
+	if (!mmc)
+		return CMD_RET_FAILURE;
+
+	if (write && mmc_getwp(mmc) == 1) {
+		printf("Error: card is write protected!\n");
+		return CMD_RET_FAILURE;
+	}
+
+	dev_desc = mmc_get_blk_desc(mmc);
+
+	start = timer_get_us();
+	if (write)
+		n = blk_dwrite(dev_desc, blk, cnt, addr);
+	else
+		n = blk_dread(dev_desc, blk, cnt, addr);
+	us = timer_get_us() - start;
+
+	if (n != cnt) {
+		printf("MMC bench: %d of %d blocks %s: ERROR\n", n, cnt,
+		       write ? "written" : "read");
+		return CMD_RET_FAILURE;
+	}
+
+	bytes = (u64)cnt * dev_desc->blksz;
+	printf("MMC bench: %s %llu bytes in %llu us", write ? "wrote" : "read",
+	       bytes, us);
+	if (us)
+		printf(", %llu KiB/s", div64_u64(bytes * 1000000, us * 1024));
+	printf("\n");
+
+	return CMD_RET_SUCCESS;
+}
+#endif
+
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
 static lbaint_t mmc_sparse_write(struct sparse_storage *info, lbaint_t blk,
 				 lbaint_t blkcnt, const void *buffer)
@@ -1120,6 +1182,9 @@ static struct cmd_tbl cmd_mmc[] = {
 #endif
 #if CONFIG_IS_ENABLED(CMD_MMC_SWRITE)
 	U_BOOT_CMD_MKENT(swrite, 3, 0, do_mmc_sparse_write, "", ""),
+#endif
+#if CONFIG_IS_ENABLED(CMD_MMC_BENCH)
+	U_BOOT_CMD_MKENT(bench, 5, 0, do_mmc_bench, "", ""),
 #endif
 	U_BOOT_CMD_MKENT(rescan, 2, 1, do_mmc_rescan, "", ""),
 	U_BOOT_CMD_MKENT(part, 1, 1, do_mmc_part, "", ""),
@@ -1181,6 +1246,10 @@ U_BOOT_CMD(
 	"mmc swrite addr blk#\n"
 #endif
 	"mmc erase blk# cnt\n"
+#if CONFIG_IS_ENABLED(CMD_MMC_BENCH)
+	"mmc bench <read|write> addr blk# cnt - time a transfer and report its throughput\n"
+	"   WARNING: the write test overwrites the blocks.\n"
+#endif
 	"mmc rescan [mode]\n"
 	"mmc part - lists available partition on current mmc device\n"
 	"mmc dev [dev] [part] [mode] - show or set current mmc device [partition] and set mode\n"
@@ -14,18 +14,45 @@
 #include <g_dnl.h>
 #include <malloc.h>
 #include <part.h>
+#include <time.h>
 #include <usb.h>
 #include <usb_mass_storage.h>
 #include <watchdog.h>
 #include <linux/delay.h>
+#include <linux/math64.h>
+
+/* Transfer statistics reported when the command exits */
+static struct {
+	u64 read_bytes;
+	u64 write_bytes;
+	u64 io_us;		/* Time spent in block I/O */
+	ulong first_ms;		/* First and last block I/O */
+	ulong last_ms;
+} ums_stats;
+
+static void ums_account(ulong start_us, u64 *bytes, ulong blks)
+{
+	ulong now = get_timer(0);
+
+	ums_stats.io_us += timer_get_us() - start_us;
+	*bytes += (u64)blks * SECTOR_SIZE;
+	if (!ums_stats.first_ms)
+		ums_stats.first_ms = now;
+	ums_stats.last_ms = now;
+}
 
 static int ums_read_sector(struct ums *ums_dev,
 			   ulong start, lbaint_t blkcnt, void *buf)
 {
 	struct blk_desc *block_dev = &ums_dev->block_dev;
 	lbaint_t blkstart = start + ums_dev->start_sector;
+	ulong start_us = timer_get_us();
+	ulong ret;
 
-	return blk_dread(block_dev, blkstart, blkcnt, buf);
+	ret = blk_dread(block_dev, blkstart, blkcnt, buf);
+	ums_account(start_us, &ums_stats.read_bytes, ret);
+
+	return ret;
 }
 
 static int ums_write_sector(struct ums *ums_dev,
@@ -33,8 +60,28 @@ static int ums_write_sector(struct ums *ums_dev,
 {
 	struct blk_desc *block_dev = &ums_dev->block_dev;
 	lbaint_t blkstart = start + ums_dev->start_sector;
+	ulong start_us = timer_get_us();
+	ulong ret;
+
+	ret = blk_dwrite(block_dev, blkstart, blkcnt, buf);
+	ums_account(start_us, &ums_stats.write_bytes, ret);
+
+	return ret;
+}
+
+static void ums_report(void)
+{
+	ulong ms = ums_stats.last_ms - ums_stats.first_ms;
+	u64 bytes = ums_stats.read_bytes + ums_stats.write_bytes;
+
+	if (!bytes)
+		return;
 
-	return blk_dwrite(block_dev, blkstart, blkcnt, buf);
+	printf("UMS: read %llu KiB, wrote %llu KiB in %lu ms",
+	       ums_stats.read_bytes >> 10, ums_stats.write_bytes >> 10, ms);
+	if (ms)
+		printf(" (%llu KiB/s)", div_u64(bytes * 1000 >> 10, ms));
+	printf(", block I/O %llu ms\n", div_u64(ums_stats.io_us, 1000));
 }
 
 static struct ums *ums;
@@ -161,6 +208,7 @@ static int do_usb_mass_storage(struct cmd_tbl *cmdtp, int flag,
 	rc = ums_init(devtype, devnum);
 	if (rc < 0)
 		return CMD_RET_FAILURE;
+	memset(&ums_stats, 0, sizeof(ums_stats));
 
 	controller_index = (unsigned int)(simple_strtoul(
 				usb_controller,	NULL, 0));
@@ -245,6 +293,7 @@ static int do_usb_mass_storage(struct cmd_tbl *cmdtp, int flag,
 	}
 
 cleanup_register:
+	ums_report();
 	g_dnl_unregister();
 cleanup_board:
 	usb_gadget_release(controller_index);
@@ -13,6 +13,7 @@
 #include <log.h>
 #include <malloc.h>
 #include <part.h>
+#include <squashfs.h>
 #include <ubifs_uboot.h>
 
 #undef	PART_DEBUG
@@ -256,6 +257,8 @@ void part_init(struct blk_desc *dev_desc)
 	struct part_driver *entry;
 
 	blkcache_invalidate(dev_desc->uclass_id, dev_desc->devnum);
+	part_cache_invalidate(dev_desc, 0, dev_desc->lba);
+	sqfs_cache_invalidate(dev_desc, 0, dev_desc->lba);
 
 	dev_desc->part_type = PART_TYPE_UNKNOWN;
 	for (entry = drv; entry != drv + n_ents; entry++) {
@@ -689,6 +692,12 @@ int part_get_info_by_name(struct blk_desc *dev_desc, const char *name,
 		return -ENOSYS;
 	}
 
+	if (part_drv->get_info_by_name) {
+		ret = part_drv->get_info_by_name(dev_desc, name, info);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
 	for (i = 1; i < part_drv->max_entries; i++) {
 		ret = part_drv->get_info(dev_desc, i, info);
 		if (ret != 0) {
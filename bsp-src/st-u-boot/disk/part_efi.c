@@ -26,6 +26,7 @@
 #include <dm/ofnode.h>
 #include <linux/compiler.h>
 #include <linux/ctype.h>
+#include <linux/list.h>
 #include <u-boot/crc.h>
 
 /* GUID for basic data partitons */
@@ -255,26 +256,13 @@ void part_print_efi(struct blk_desc *dev_desc)
 	return;
 }
 
-int part_get_info_efi(struct blk_desc *dev_desc, int part,
-		      struct disk_partition *info)
+static int gpt_get_info(struct blk_desc *dev_desc, gpt_header *gpt_head,
+			gpt_entry *gpt_pte, int part,
+			struct disk_partition *info)
 {
-	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, dev_desc->blksz);
-	gpt_entry *gpt_pte = NULL;
-
-	/* "part" argument must be at least 1 */
-	if (part < 1) {
-		log_debug("Invalid Argument(s)\n");
-		return -EINVAL;
-	}
-
-	/* This function validates AND fills in the GPT header and PTE */
-	if (find_valid_gpt(dev_desc, gpt_head, &gpt_pte) != 1)
-		return -EINVAL;
-
 	if (part > le32_to_cpu(gpt_head->num_partition_entries) ||
 	    !is_pte_valid(&gpt_pte[part - 1])) {
 		log_debug("Invalid partition number %d\n", part);
-		free(gpt_pte);
 		return -EPERM;
 	}
 
@@ -301,9 +289,204 @@ int part_get_info_efi(struct blk_desc *dev_desc, int part,
 	log_debug("start 0x" LBAF ", size 0x" LBAF ", name %s\n", info->start,
 		  info->size, info->name);
 
+	return 0;
+}
+
+/*
+ * Validated GPT of a block device, with an open addressing hash table of
+ * the partition names. It is dropped when the device is rescanned or when
+ * the blocks outside of the usable area are written.
+ */
+struct gpt_cache_node {
+	struct list_head lh;
+	enum uclass_id uclass_id;
+	int devnum;
+	int hwpart;
+	lbaint_t lba;
+	lbaint_t first_usable;
+	lbaint_t last_usable;
+	gpt_header *head;
+	gpt_entry *pte;
+	u16 *names;		/* partition number, 0 for a free slot */
+	u32 names_mask;
+};
+
+#if CONFIG_IS_ENABLED(PARTITION_CACHE)
+static LIST_HEAD(gpt_cache);
+
+static u32 gpt_cache_name_hash(const char *name)
+{
+	u32 hash = 2166136261U;
+
+	while (*name)
+		hash = (hash ^ (u8)*name++) * 16777619U;
+
+	return hash;
+}
+
+static void gpt_cache_free(struct gpt_cache_node *node)
+{
+	list_del(&node->lh);
+	free(node->names);
+	free(node->pte);
+	free(node->head);
+	free(node);
+}
+
+static int gpt_cache_index_names(struct gpt_cache_node *node)
+{
+	u32 count = le32_to_cpu(node->head->num_partition_entries);
+	char name[PART_NAME_LEN];
+	u32 size = 16;
+	u32 i, slot;
+
+	/*
+	 * Only index what part_get_info_by_name() can find: the entries
+	 * before the first unused one.
+	 */
+	count = min(count, (u32)GPT_ENTRY_NUMBERS - 1);
+	while (size < 2 * count)
+		size <<= 1;
+
+	node->names = calloc(size, sizeof(*node->names));
+	if (!node->names)
+		return -ENOMEM;
+	node->names_mask = size - 1;
+
+	for (i = 0; i < count && is_pte_valid(&node->pte[i]); i++) {
+		snprintf(name, sizeof(name), "%s", print_efiname(&node->pte[i]));
+		slot = gpt_cache_name_hash(name) & node->names_mask;
+		while (node->names[slot])
+			slot = (slot + 1) & node->names_mask;
+		node->names[slot] = i + 1;
+	}
+
+	return 0;
+}
+
+static struct gpt_cache_node *gpt_cache_get(struct blk_desc *dev_desc)
+{
+	struct gpt_cache_node *node;
+	gpt_header *gpt_head;
+	gpt_entry *gpt_pte;
+
+	list_for_each_entry(node, &gpt_cache, lh) {
+		if (node->uclass_id != dev_desc->uclass_id ||
+		    node->devnum != dev_desc->devnum ||
+		    node->hwpart != dev_desc->hwpart)
+			continue;
+		if (node->lba == dev_desc->lba)
+			return node;
+		/* The medium changed */
+		gpt_cache_free(node);
+		break;
+	}
+
+	node = calloc(1, sizeof(*node));
+	gpt_head = memalign(ARCH_DMA_MINALIGN,
+			    PAD_TO_BLOCKSIZE(sizeof(*gpt_head), dev_desc));
+	if (!node || !gpt_head)
+		goto err;
+
+	if (find_valid_gpt(dev_desc, gpt_head, &gpt_pte) != 1)
+		goto err;
+
+	node->uclass_id = dev_desc->uclass_id;
+	node->devnum = dev_desc->devnum;
+	node->hwpart = dev_desc->hwpart;
+	node->lba = dev_desc->lba;
+	node->first_usable = le64_to_cpu(gpt_head->first_usable_lba);
+	node->last_usable = le64_to_cpu(gpt_head->last_usable_lba);
+	node->head = gpt_head;
+	node->pte = gpt_pte;
+	if (gpt_cache_index_names(node)) {
+		free(gpt_pte);
+		goto err;
+	}
+	list_add(&node->lh, &gpt_cache);
+
+	return node;
+
+err:
+	free(gpt_head);
+	free(node);
+	return NULL;
+}
+
+void part_cache_invalidate(struct blk_desc *dev_desc, lbaint_t start,
+			   lbaint_t blkcnt)
+{
+	struct gpt_cache_node *node, *tmp;
+
+	list_for_each_entry_safe(node, tmp, &gpt_cache, lh) {
+		if (node->uclass_id != dev_desc->uclass_id ||
+		    node->devnum != dev_desc->devnum ||
+		    node->hwpart != dev_desc->hwpart)
+			continue;
+		if (start < node->first_usable ||
+		    start + blkcnt > node->last_usable + 1)
+			gpt_cache_free(node);
+	}
+}
+
+static int part_get_info_by_name_efi(struct blk_desc *dev_desc,
+				     const char *name,
+				     struct disk_partition *info)
+{
+	struct gpt_cache_node *node;
+	u32 slot;
+	int part;
+
+	node = gpt_cache_get(dev_desc);
+	if (!node)
+		return -ENOSYS;
+
+	slot = gpt_cache_name_hash(name) & node->names_mask;
+	for (; node->names[slot]; slot = (slot + 1) & node->names_mask) {
+		part = node->names[slot];
+		if (gpt_get_info(dev_desc, node->head, node->pte, part, info))
+			continue;
+		if (!strcmp(name, (const char *)info->name))
+			return part;
+	}
+
+	return -ENOENT;
+}
+#else
+static struct gpt_cache_node *gpt_cache_get(struct blk_desc *dev_desc)
+{
+	return NULL;
+}
+#endif
+
+int part_get_info_efi(struct blk_desc *dev_desc, int part,
+		      struct disk_partition *info)
+{
+	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, dev_desc->blksz);
+	struct gpt_cache_node *node;
+	gpt_entry *gpt_pte = NULL;
+	int ret;
+
+	/* "part" argument must be at least 1 */
+	if (part < 1) {
+		log_debug("Invalid Argument(s)\n");
+		return -EINVAL;
+	}
+
+	node = gpt_cache_get(dev_desc);
+	if (node)
+		return gpt_get_info(dev_desc, node->head, node->pte, part,
+				    info);
+
+	/* This function validates AND fills in the GPT header and PTE */
+	if (find_valid_gpt(dev_desc, gpt_head, &gpt_pte) != 1)
+		return -EINVAL;
+
+	ret = gpt_get_info(dev_desc, gpt_head, gpt_pte, part, info);
+
 	/* Remember to free pte */
 	free(gpt_pte);
-	return 0;
+	return ret;
 }
 
 static int part_test_efi(struct blk_desc *dev_desc)
@@ -1192,6 +1375,9 @@ U_BOOT_PART_TYPE(a_efi) = {
 	.part_type	= PART_TYPE_EFI,
 	.max_entries	= GPT_ENTRY_NUMBERS,
 	.get_info	= part_get_info_ptr(part_get_info_efi),
+#if CONFIG_IS_ENABLED(PARTITION_CACHE)
+	.get_info_by_name = part_get_info_by_name_efi,
+#endif
 	.print		= part_print_ptr(part_print_efi),
 	.test		= part_test_efi,
 };
@@ -8,10 +8,12 @@
 
 #include <common.h>
 #include <blk.h>
+#include <cyclic.h>
 #include <dm.h>
 #include <log.h>
 #include <malloc.h>
 #include <part.h>
+#include <squashfs.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 #include <dm/uclass-internal.h>
@@ -354,6 +356,24 @@ ulong blk_write_devnum(enum uclass_id uclass_id, int devnum, lbaint_t start,
 	return blk_dwrite(desc, start, blkcnt, buffer);
 }
 
+/*
+ * Synchronous accesses are not ordered against the asynchronous requests
+ * queued on the device: complete these first. Accesses made by the driver
+ * while it starts or polls the head of the queue belong to that request and
+ * must not wait for it.
+ */
+static void blk_async_drain(struct udevice *dev)
+{
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+
+	while (desc->async_head && !desc->async_in_driver) {
+		blk_poll(dev);
+		schedule();
+	}
+#endif
+}
+
 int blk_select_hwpart(struct udevice *dev, int hwpart)
 {
 	const struct blk_ops *ops = blk_get_ops(dev);
@@ -363,6 +383,8 @@ int blk_select_hwpart(struct udevice *dev, int hwpart)
 	if (!ops->select_hwpart)
 		return 0;
 
+	blk_async_drain(dev);
+
 	return ops->select_hwpart(dev, hwpart);
 }
 
@@ -444,7 +466,8 @@ int blk_get_device(int uclass_id, int devnum, struct udevice **devp)
 	return device_probe(*devp);
 }
 
-long blk_read(struct udevice *dev, lbaint_t start, lbaint_t blkcnt, void *buf)
+static long _blk_read(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
+		      void *buf)
 {
 	struct blk_desc *desc = dev_get_uclass_plat(dev);
 	const struct blk_ops *ops = blk_get_ops(dev);
@@ -464,8 +487,8 @@ long blk_read(struct udevice *dev, lbaint_t start, lbaint_t blkcnt, void *buf)
 	return blks_read;
 }
 
-long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
-	       const void *buf)
+static long _blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
+		       const void *buf)
 {
 	struct blk_desc *desc = dev_get_uclass_plat(dev);
 	const struct blk_ops *ops = blk_get_ops(dev);
@@ -474,10 +497,27 @@ long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
 		return -ENOSYS;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	part_cache_invalidate(desc, start, blkcnt);
+	sqfs_cache_invalidate(desc, start, blkcnt);
 
 	return ops->write(dev, start, blkcnt, buf);
 }
 
+long blk_read(struct udevice *dev, lbaint_t start, lbaint_t blkcnt, void *buf)
+{
+	blk_async_drain(dev);
+
+	return _blk_read(dev, start, blkcnt, buf);
+}
+
+long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
+	       const void *buf)
+{
+	blk_async_drain(dev);
+
+	return _blk_write(dev, start, blkcnt, buf);
+}
+
 long blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt)
 {
 	struct blk_desc *desc = dev_get_uclass_plat(dev);
@@ -486,11 +526,125 @@ long blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt)
 	if (!ops->erase)
 		return -ENOSYS;
 
+	blk_async_drain(dev);
+
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	part_cache_invalidate(desc, start, blkcnt);
+	sqfs_cache_invalidate(desc, start, blkcnt);
 
 	return ops->erase(dev, start, blkcnt);
 }
 
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+/*
+ * Have the driver start @req, the head of the queue. Drivers without
+ * asynchronous support transfer it right away, in which case its final
+ * status is set.
+ */
+static void blk_async_start(struct udevice *dev, struct blk_req *req)
+{
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+	const struct blk_ops *ops = blk_get_ops(dev);
+	int ret = -ENOSYS;
+
+	desc->async_in_driver = true;
+
+	if (ops->submit)
+		ret = ops->submit(dev, req);
+	if (!ret)
+		desc->async_busy = true;
+	else if (ret != -ENOSYS)
+		req->status = ret;
+	else if (req->op == BLK_REQ_READ)
+		req->status = _blk_read(dev, req->start, req->blkcnt,
+					req->buffer);
+	else
+		req->status = _blk_write(dev, req->start, req->blkcnt,
+					 req->buffer);
+
+	desc->async_in_driver = false;
+}
+
+int blk_submit(struct udevice *dev, struct blk_req *req)
+{
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+
+	if (req->op != BLK_REQ_READ && req->op != BLK_REQ_WRITE)
+		return -EINVAL;
+
+	if (req->op == BLK_REQ_WRITE) {
+		blkcache_invalidate(desc->uclass_id, desc->devnum);
+		part_cache_invalidate(desc, req->start, req->blkcnt);
+		sqfs_cache_invalidate(desc, req->start, req->blkcnt);
+	}
+
+	req->dev = dev;
+	req->status = -EINPROGRESS;
+	req->next = NULL;
+	if (desc->async_tail)
+		desc->async_tail->next = req;
+	else
+		desc->async_head = req;
+	desc->async_tail = req;
+
+	/* Start it right away when the device is idle */
+	if (desc->async_head == req) {
+		blk_async_start(dev, req);
+		if (req->status != -EINPROGRESS)
+			blk_poll(dev);
+	}
+
+	return 0;
+}
+
+int blk_poll(struct udevice *dev)
+{
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+	const struct blk_ops *ops = blk_get_ops(dev);
+	struct blk_req *req;
+	long ret;
+	int count;
+
+	while ((req = desc->async_head)) {
+		if (desc->async_busy) {
+			desc->async_in_driver = true;
+			ret = ops->poll(dev, req);
+			desc->async_in_driver = false;
+			if (ret == -EINPROGRESS)
+				break;
+			desc->async_busy = false;
+			req->status = ret;
+		}
+
+		desc->async_head = req->next;
+		if (!desc->async_head)
+			desc->async_tail = NULL;
+
+		/* Keep the device busy while the callback runs */
+		if (desc->async_head)
+			blk_async_start(dev, desc->async_head);
+
+		if (req->complete)
+			req->complete(req);
+	}
+
+	for (count = 0, req = desc->async_head; req; req = req->next)
+		count++;
+
+	return count;
+}
+
+long blk_wait(struct blk_req *req)
+{
+	while (req->status == -EINPROGRESS) {
+		blk_poll(req->dev);
+		schedule();
+	}
+
+	return req->status;
+}
+#endif
+
 ulong blk_dread(struct blk_desc *desc, lbaint_t start, lbaint_t blkcnt,
 		void *buffer)
 {
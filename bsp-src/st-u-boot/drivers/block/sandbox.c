@@ -56,9 +56,33 @@ static unsigned long host_block_write(struct udevice *dev,
 	return -EIO;
 }
 
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+/*
+ * Sandbox has no background I/O: model a device that transfers on its
+ * own by only accessing the file when the request is polled.
+ */
+static int host_block_submit(struct udevice *dev, struct blk_req *req)
+{
+	return 0;
+}
+
+static long host_block_poll(struct udevice *dev, struct blk_req *req)
+{
+	if (req->op == BLK_REQ_READ)
+		return host_block_read(dev, req->start, req->blkcnt,
+				       req->buffer);
+
+	return host_block_write(dev, req->start, req->blkcnt, req->buffer);
+}
+#endif
+
 static const struct blk_ops sandbox_host_blk_ops = {
 	.read	= host_block_read,
 	.write	= host_block_write,
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	.submit	= host_block_submit,
+	.poll	= host_block_poll,
+#endif
 };
 
 U_BOOT_DRIVER(sandbox_host_blk) = {
@@ -11,6 +11,7 @@
 #include <stm32_omi.h>
 #include <syscon.h>
 #include <watchdog.h>
+#include <asm/unaligned.h>
 #include <dm/of_access.h>
 #include <dm/device-internal.h>
 #include <dm/device_compat.h>
@@ -297,21 +298,45 @@ static void stm32_omi_write_fifo(u8 *val, phys_addr_t addr)
 	writeb(*val, addr);
 }
 
+static void stm32_omi_read_fifo_word(u8 *val, phys_addr_t addr)
+{
+	put_unaligned(readl(addr), (u32 *)val);
+	schedule();
+}
+
+static void stm32_omi_write_fifo_word(u8 *val, phys_addr_t addr)
+{
+	writel(get_unaligned((u32 *)val), addr);
+}
+
 int stm32_omi_tx_poll(struct udevice *dev, u8 *buf, u32 len, bool read)
 {
 	struct stm32_omi_plat *omi_plat = dev_get_plat(dev);
 	struct stm32_omi_priv *omi_priv = dev_get_priv(dev);
 	phys_addr_t regs_base = omi_plat->regs_base;
 	void (*fifo)(u8 *val, phys_addr_t addr);
-	u32 sr;
+	void (*fifo_word)(u8 *val, phys_addr_t addr);
+	u32 sr, step;
+	bool word;
 	int ret;
 
-	if (read)
+	if (read) {
 		fifo = stm32_omi_read_fifo;
-	else
+		fifo_word = stm32_omi_read_fifo_word;
+	} else {
 		fifo = stm32_omi_write_fifo;
+		fifo_word = stm32_omi_write_fifo_word;
+	}
+
+	/*
+	 * FTF guarantees at least FTHRES + 1 bytes (or free locations) in the
+	 * FIFO: with a threshold of 4 bytes or more, move whole 32-bit words
+	 * and finish the transfer byte per byte.
+	 */
+	word = FIELD_GET(OSPI_CR_FTHRES_MASK,
+			 readl(regs_base + OSPI_CR)) >= sizeof(u32) - 1;
 
-	while (len--) {
+	while (len) {
 		ret = readl_poll_timeout(regs_base + OSPI_SR, sr,
 					 sr & OSPI_SR_FTF,
 					 OSPI_FIFO_TIMEOUT_US);
@@ -322,7 +347,16 @@ int stm32_omi_tx_poll(struct udevice *dev, u8 *buf, u32 len, bool read)
 			return ret;
 		}
 
-		fifo(buf++, regs_base + OSPI_DR);
+		if (word && len >= sizeof(u32)) {
+			fifo_word(buf, regs_base + OSPI_DR);
+			step = sizeof(u32);
+		} else {
+			fifo(buf, regs_base + OSPI_DR);
+			step = 1;
+		}
+
+		buf += step;
+		len -= step;
 	}
 
 	return 0;
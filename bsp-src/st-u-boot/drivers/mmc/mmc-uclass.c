@@ -12,6 +12,7 @@
 #include <log.h>
 #include <mmc.h>
 #include <dm.h>
+#include <asm/cache.h>
 #include <dm/device-internal.h>
 #include <dm/device_compat.h>
 #include <dm/lists.h>
@@ -56,6 +57,41 @@ int mmc_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 	return dm_mmc_send_cmd(mmc->dev, cmd, data);
 }
 
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+int mmc_send_cmd_start(struct mmc *mmc, struct mmc_cmd *cmd,
+		       struct mmc_data *data)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(mmc->dev);
+	int ret;
+
+	if (!ops->send_cmd_start)
+		return -ENOSYS;
+
+	mmmc_trace_before_send(mmc, cmd);
+	ret = ops->send_cmd_start(mmc->dev, cmd, data);
+	if (ret)
+		mmmc_trace_after_send(mmc, cmd, ret);
+
+	return ret;
+}
+
+int mmc_send_cmd_poll(struct mmc *mmc, struct mmc_cmd *cmd,
+		      struct mmc_data *data)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(mmc->dev);
+	int ret;
+
+	if (!ops->send_cmd_poll)
+		return -ENOSYS;
+
+	ret = ops->send_cmd_poll(mmc->dev, cmd, data);
+	if (ret != -EINPROGRESS)
+		mmmc_trace_after_send(mmc, cmd, ret);
+
+	return ret;
+}
+#endif
+
 static int dm_mmc_set_ios(struct udevice *dev)
 {
 	struct dm_mmc_ops *ops = mmc_get_ops(dev);
@@ -518,6 +554,134 @@ static int mmc_blk_remove(struct udevice *dev)
 }
 #endif
 
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+/* Start the data command for the next part of @req */
+static int mmc_async_start(struct mmc *mmc, struct blk_req *req)
+{
+	struct mmc_cmd *cmd = &mmc->async_cmd;
+	struct mmc_data *data = &mmc->async_data;
+	bool read = req->op == BLK_REQ_READ;
+	uint blksz = read ? mmc->read_bl_len : mmc->write_bl_len;
+	lbaint_t start = req->start + mmc->async_done;
+	lbaint_t blkcnt = req->blkcnt - mmc->async_done;
+	char *buf = req->buffer + mmc->async_done * blksz;
+
+	blkcnt = min_t(lbaint_t, blkcnt, mmc_get_b_max(mmc, buf, blkcnt));
+
+	if (read) {
+		cmd->cmdidx = blkcnt > 1 ? MMC_CMD_READ_MULTIPLE_BLOCK :
+					   MMC_CMD_READ_SINGLE_BLOCK;
+		data->dest = buf;
+		data->flags = MMC_DATA_READ;
+	} else {
+		cmd->cmdidx = blkcnt > 1 ? MMC_CMD_WRITE_MULTIPLE_BLOCK :
+					   MMC_CMD_WRITE_SINGLE_BLOCK;
+		data->src = buf;
+		data->flags = MMC_DATA_WRITE;
+	}
+	cmd->cmdarg = mmc->high_capacity ? start : start * blksz;
+	cmd->resp_type = MMC_RSP_R1;
+	data->blocks = blkcnt;
+	data->blocksize = blksz;
+
+	return mmc_send_cmd_start(mmc, cmd, data);
+}
+
+/* Finish @req with the synchronous path, which retries failed commands */
+static long mmc_async_fallback(struct udevice *dev, struct mmc *mmc,
+			       struct blk_req *req)
+{
+	bool read = req->op == BLK_REQ_READ;
+	uint blksz = read ? mmc->read_bl_len : mmc->write_bl_len;
+	lbaint_t start = req->start + mmc->async_done;
+	lbaint_t blkcnt = req->blkcnt - mmc->async_done;
+	char *buf = req->buffer + mmc->async_done * blksz;
+	ulong done = 0;
+
+	if (read)
+		done = mmc_bread(dev, start, blkcnt, buf);
+#if CONFIG_IS_ENABLED(MMC_WRITE)
+	else
+		done = mmc_bwrite(dev, start, blkcnt, buf);
+#endif
+
+	return done == blkcnt ? req->blkcnt : -EIO;
+}
+
+static int mmc_blk_submit(struct udevice *dev, struct blk_req *req)
+{
+	struct udevice *mmc_dev = dev_get_parent(dev);
+	struct mmc *mmc = mmc_get_mmc_dev(mmc_dev);
+	struct dm_mmc_ops *ops = mmc_get_ops(mmc_dev);
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+	bool read = req->op == BLK_REQ_READ;
+	int ret;
+
+	if (!ops->send_cmd_start || !ops->send_cmd_poll ||
+	    mmc_host_is_spi(mmc) || !req->blkcnt ||
+	    (!read && !CONFIG_IS_ENABLED(MMC_WRITE)))
+		return -ENOSYS;
+
+	if (req->start + req->blkcnt > desc->lba)
+		return -EINVAL;
+
+	/*
+	 * The caches are only maintained at the end of the transfer, which
+	 * must not touch data sharing a cache line with the buffer
+	 */
+	if (!IS_ALIGNED((ulong)req->buffer, ARCH_DMA_MINALIGN) ||
+	    !IS_ALIGNED((ulong)req->buffer + req->blkcnt * desc->blksz,
+			ARCH_DMA_MINALIGN))
+		return -ENOSYS;
+
+	ret = blk_dselect_hwpart(desc, desc->hwpart);
+	if (ret)
+		return ret;
+
+	ret = mmc_set_blocklen(mmc, read ? mmc->read_bl_len :
+				     mmc->write_bl_len);
+	if (ret)
+		return ret;
+
+	mmc->async_done = 0;
+	ret = mmc_async_start(mmc, req);
+	if (ret) {
+		/* Let the caller complete the request synchronously */
+		return -ENOSYS;
+	}
+
+	return 0;
+}
+
+static long mmc_blk_poll(struct udevice *dev, struct blk_req *req)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev_get_parent(dev));
+	struct mmc_data *data = &mmc->async_data;
+	bool write = req->op == BLK_REQ_WRITE;
+	int ret;
+
+	ret = mmc_send_cmd_poll(mmc, &mmc->async_cmd, data);
+	if (ret == -EINPROGRESS)
+		return ret;
+
+	if (!ret && data->blocks > 1)
+		ret = mmc_send_stop_transmission(mmc, write);
+	if (!ret && write)
+		ret = mmc_poll_for_busy(mmc, 1000);
+	if (ret)
+		return mmc_async_fallback(dev, mmc, req);
+
+	mmc->async_done += data->blocks;
+	if (mmc->async_done == req->blkcnt)
+		return req->blkcnt;
+
+	if (mmc_async_start(mmc, req))
+		return mmc_async_fallback(dev, mmc, req);
+
+	return -EINPROGRESS;
+}
+#endif
+
 static const struct blk_ops mmc_blk_ops = {
 	.read	= mmc_bread,
 #if CONFIG_IS_ENABLED(MMC_WRITE)
@@ -525,6 +689,10 @@ static const struct blk_ops mmc_blk_ops = {
 	.erase	= mmc_berase,
 #endif
 	.select_hwpart	= mmc_select_hwpart,
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	.submit	= mmc_blk_submit,
+	.poll	= mmc_blk_poll,
+#endif
 };
 
 U_BOOT_DRIVER(mmc_blk) = {
@@ -31,6 +31,7 @@ struct sandbox_mmc_priv {
 	char *buf;
 	int csize;	/* CSIZE value to report */
 	int size;
+	int async_errors;	/* asynchronous transfers left to fail */
 };
 
 /**
@@ -139,10 +140,45 @@ static int sandbox_mmc_get_cd(struct udevice *dev)
 	return 1;
 }
 
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+/* The data is copied once the transfer is polled */
+static int sandbox_mmc_send_cmd_start(struct udevice *dev,
+				      struct mmc_cmd *cmd,
+				      struct mmc_data *data)
+{
+	return 0;
+}
+
+static int sandbox_mmc_send_cmd_poll(struct udevice *dev,
+				     struct mmc_cmd *cmd,
+				     struct mmc_data *data)
+{
+	struct sandbox_mmc_priv *priv = dev_get_priv(dev);
+
+	if (priv->async_errors) {
+		priv->async_errors--;
+		return -ETIMEDOUT;
+	}
+
+	return sandbox_mmc_send_cmd(dev, cmd, data);
+}
+
+void sandbox_mmc_set_async_errors(struct udevice *dev, int count)
+{
+	struct sandbox_mmc_priv *priv = dev_get_priv(dev);
+
+	priv->async_errors = count;
+}
+#endif
+
 static const struct dm_mmc_ops sandbox_mmc_ops = {
 	.send_cmd = sandbox_mmc_send_cmd,
 	.set_ios = sandbox_mmc_set_ios,
 	.get_cd = sandbox_mmc_get_cd,
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	.send_cmd_start = sandbox_mmc_send_cmd_start,
+	.send_cmd_poll = sandbox_mmc_send_cmd_poll,
+#endif
 };
 
 static int sandbox_mmc_of_to_plat(struct udevice *dev)
@@ -28,6 +28,13 @@
 #include <power/regulator.h>
 #include <watchdog.h>
 
+struct stm32_sdmmc2_ctx {
+	u32 cache_start;
+	u32 cache_end;
+	u32 data_length;
+	bool dpsm_abort;
+};
+
 struct stm32_sdmmc2_plat {
 	struct mmc_config cfg;
 	struct mmc mmc;
@@ -40,13 +47,9 @@ struct stm32_sdmmc2_plat {
 #if CONFIG_IS_ENABLED(DM_REGULATOR)
 	bool vqmmc_enabled;
 #endif
-};
-
-struct stm32_sdmmc2_ctx {
-	u32 cache_start;
-	u32 cache_end;
-	u32 data_length;
-	bool dpsm_abort;
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	struct stm32_sdmmc2_ctx async_ctx;
+#endif
 };
 
 /* SDMMC REGISTERS OFFSET */
@@ -202,6 +205,9 @@ struct stm32_sdmmc2_ctx {
 /* SDMMC_IDMACTRL register */
 #define SDMMC_IDMACTRL_IDMAEN		BIT(0)
 
+/* SDMMC_DLEN register */
+#define SDMMC_DLEN_MAX			GENMASK(24, 0)
+
 #define SDMMC_CMD_TIMEOUT		0xFFFFFFFF
 #define SDMMC_BUSYD0END_TIMEOUT_US	2000000
 
@@ -235,12 +241,22 @@ static void stm32_sdmmc2_start_data(struct udevice *dev,
 	ctx->cache_end = roundup(idmabase0 + ctx->data_length,
 				 ARCH_DMA_MINALIGN);
 
-	/*
-	 * Flush data cache before DMA start (clean and invalidate)
-	 * Clean also needed for read
-	 * Avoid issue on buffer not cached-aligned
-	 */
-	flush_dcache_range(ctx->cache_start, ctx->cache_end);
+	if (data->flags & MMC_DATA_READ) {
+		/*
+		 * The buffer is only written by the IDMA: clean the partial
+		 * cache lines shared with other data at both ends, and just
+		 * invalidate the rest instead of writing it back.
+		 */
+		if (idmabase0 != ctx->cache_start)
+			flush_dcache_range(ctx->cache_start,
+					   ctx->cache_start + ARCH_DMA_MINALIGN);
+		if (idmabase0 + ctx->data_length != ctx->cache_end)
+			flush_dcache_range(ctx->cache_end - ARCH_DMA_MINALIGN,
+					   ctx->cache_end);
+		invalidate_dcache_range(ctx->cache_start, ctx->cache_end);
+	} else {
+		flush_dcache_range(ctx->cache_start, ctx->cache_end);
+	}
 
 	/* Enable internal DMA */
 	writel(idmabase0, plat->base + SDMMC_IDMABASE0);
@@ -376,21 +392,29 @@ static int stm32_sdmmc2_end_cmd(struct udevice *dev,
 	return 0;
 }
 
-static int stm32_sdmmc2_end_data(struct udevice *dev,
-				 struct mmc_cmd *cmd,
-				 struct mmc_data *data,
-				 struct stm32_sdmmc2_ctx *ctx)
+/* Status flags ending a data transfer */
+static u32 stm32_sdmmc2_data_mask(struct mmc_data *data)
 {
-	struct stm32_sdmmc2_plat *plat = dev_get_plat(dev);
 	u32 mask = SDMMC_STA_DCRCFAIL | SDMMC_STA_DTIMEOUT |
 		   SDMMC_STA_IDMATE | SDMMC_STA_DATAEND;
-	u32 status;
 
 	if (data->flags & MMC_DATA_READ)
 		mask |= SDMMC_STA_RXOVERR;
 	else
 		mask |= SDMMC_STA_TXUNDERR;
 
+	return mask;
+}
+
+static int stm32_sdmmc2_end_data(struct udevice *dev,
+				 struct mmc_cmd *cmd,
+				 struct mmc_data *data,
+				 struct stm32_sdmmc2_ctx *ctx)
+{
+	struct stm32_sdmmc2_plat *plat = dev_get_plat(dev);
+	u32 mask = stm32_sdmmc2_data_mask(data);
+	u32 status;
+
 	status = readl(plat->base + SDMMC_STA);
 	while (!(status & mask))
 		status = readl(plat->base + SDMMC_STA);
@@ -441,10 +465,44 @@ static int stm32_sdmmc2_end_data(struct udevice *dev,
 	return 0;
 }
 
+/*
+ * Clear the flags and stop the internal DMA once a command is over. On
+ * errors, a stop_transmission command is also needed to stop the Data Path
+ * State Machine.
+ */
+static void stm32_sdmmc2_end_transfer(struct udevice *dev,
+				      struct mmc_cmd *cmd,
+				      struct mmc_data *data,
+				      struct stm32_sdmmc2_ctx *ctx)
+{
+	struct stm32_sdmmc2_plat *plat = dev_get_plat(dev);
+
+	writel(SDMMC_ICR_STATIC_FLAGS, plat->base + SDMMC_ICR);
+	if (data)
+		writel(0x0, plat->base + SDMMC_IDMACTRL);
+
+	if (ctx->dpsm_abort && (cmd->cmdidx != MMC_CMD_STOP_TRANSMISSION)) {
+		struct mmc_cmd stop_cmd;
+
+		stop_cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
+		stop_cmd.cmdarg = 0;
+		stop_cmd.resp_type = MMC_RSP_R1b;
+
+		dev_dbg(dev, "send STOP command to abort dpsm treatments\n");
+
+		ctx->data_length = 0;
+
+		stm32_sdmmc2_start_cmd(dev, &stop_cmd,
+				       SDMMC_CMD_CMDSTOP, ctx);
+		stm32_sdmmc2_end_cmd(dev, &stop_cmd, ctx);
+
+		writel(SDMMC_ICR_STATIC_FLAGS, plat->base + SDMMC_ICR);
+	}
+}
+
 static int stm32_sdmmc2_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 				 struct mmc_data *data)
 {
-	struct stm32_sdmmc2_plat *plat = dev_get_plat(dev);
 	struct stm32_sdmmc2_ctx ctx;
 	u32 cmdat = data ? SDMMC_CMD_CMDTRANS : 0;
 	int ret, retry = 3;
@@ -470,32 +528,7 @@ retry_cmd:
 	if (data && !ret)
 		ret = stm32_sdmmc2_end_data(dev, cmd, data, &ctx);
 
-	/* Clear flags */
-	writel(SDMMC_ICR_STATIC_FLAGS, plat->base + SDMMC_ICR);
-	if (data)
-		writel(0x0, plat->base + SDMMC_IDMACTRL);
-
-	/*
-	 * To stop Data Path State Machine, a stop_transmission command
-	 * shall be send on cmd or data errors.
-	 */
-	if (ctx.dpsm_abort && (cmd->cmdidx != MMC_CMD_STOP_TRANSMISSION)) {
-		struct mmc_cmd stop_cmd;
-
-		stop_cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
-		stop_cmd.cmdarg = 0;
-		stop_cmd.resp_type = MMC_RSP_R1b;
-
-		dev_dbg(dev, "send STOP command to abort dpsm treatments\n");
-
-		ctx.data_length = 0;
-
-		stm32_sdmmc2_start_cmd(dev, &stop_cmd,
-				       SDMMC_CMD_CMDSTOP, &ctx);
-		stm32_sdmmc2_end_cmd(dev, &stop_cmd, &ctx);
-
-		writel(SDMMC_ICR_STATIC_FLAGS, plat->base + SDMMC_ICR);
-	}
+	stm32_sdmmc2_end_transfer(dev, cmd, data, &ctx);
 
 	if ((ret != -ETIMEDOUT) && (ret != 0) && retry) {
 		dev_err(dev, "cmd %d failed, retrying ...\n", cmd->cmdidx);
@@ -508,6 +541,52 @@ retry_cmd:
 	return ret;
 }
 
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+/*
+ * Data commands for asynchronous block requests: the response is waited
+ * for, then the IDMA transfer runs until send_cmd_poll() sees its end.
+ * Failures are not retried here, the MMC core falls back to send_cmd().
+ */
+static int stm32_sdmmc2_send_cmd_start(struct udevice *dev,
+				       struct mmc_cmd *cmd,
+				       struct mmc_data *data)
+{
+	struct stm32_sdmmc2_plat *plat = dev_get_plat(dev);
+	struct stm32_sdmmc2_ctx *ctx = &plat->async_ctx;
+	int ret;
+
+	schedule();
+
+	ctx->data_length = data->blocks * data->blocksize;
+	ctx->dpsm_abort = false;
+	stm32_sdmmc2_start_data(dev, data, ctx);
+	stm32_sdmmc2_start_cmd(dev, cmd, SDMMC_CMD_CMDTRANS, ctx);
+
+	ret = stm32_sdmmc2_end_cmd(dev, cmd, ctx);
+	if (ret)
+		stm32_sdmmc2_end_transfer(dev, cmd, data, ctx);
+
+	return ret;
+}
+
+static int stm32_sdmmc2_send_cmd_poll(struct udevice *dev,
+				      struct mmc_cmd *cmd,
+				      struct mmc_data *data)
+{
+	struct stm32_sdmmc2_plat *plat = dev_get_plat(dev);
+	struct stm32_sdmmc2_ctx *ctx = &plat->async_ctx;
+	int ret;
+
+	if (!(readl(plat->base + SDMMC_STA) & stm32_sdmmc2_data_mask(data)))
+		return -EINPROGRESS;
+
+	ret = stm32_sdmmc2_end_data(dev, cmd, data, ctx);
+	stm32_sdmmc2_end_transfer(dev, cmd, data, ctx);
+
+	return ret;
+}
+#endif
+
 /*
  * Reset the SDMMC with the RCC.SDMMCxRST register bit.
  * This will reset the SDMMC to the reset state and the CPSM and DPSM
@@ -659,6 +738,10 @@ static const struct dm_mmc_ops stm32_sdmmc2_ops = {
 	.set_ios = stm32_sdmmc2_set_ios,
 	.get_cd = stm32_sdmmc2_getcd,
 	.host_power_cycle = stm32_sdmmc2_host_power_cycle,
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	.send_cmd_start = stm32_sdmmc2_send_cmd_start,
+	.send_cmd_poll = stm32_sdmmc2_send_cmd_poll,
+#endif
 };
 
 static int stm32_sdmmc2_of_to_plat(struct udevice *dev)
@@ -680,7 +763,9 @@ static int stm32_sdmmc2_of_to_plat(struct udevice *dev)
 
 	cfg->f_min = 400000;
 	cfg->voltages = MMC_VDD_32_33 | MMC_VDD_33_34 | MMC_VDD_165_195;
-	cfg->b_max = CONFIG_SYS_MMC_MAX_BLK_COUNT;
+	/* A whole transfer must fit in the data length register */
+	cfg->b_max = min_t(u32, CONFIG_SYS_MMC_MAX_BLK_COUNT,
+			   SDMMC_DLEN_MAX / MMC_MAX_BLOCK_LEN);
 	cfg->name = "STM32 SD/MMC";
 	cfg->host_caps = 0;
 	cfg->f_max = 52000000;
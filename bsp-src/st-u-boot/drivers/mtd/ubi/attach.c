@@ -819,7 +819,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		    int pnum, int *vid, unsigned long long *sqnum)
 {
 	long long uninitialized_var(ec);
-	int err, bitflips = 0, vol_id = -1, ec_err = 0;
+	int err, bitflips = 0, vol_id = -1, ec_err = 0, vid_err = 0;
 
 	dbg_bld("scan PEB %d", pnum);
 
@@ -832,7 +832,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		return 0;
 	}
 
-	err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
+	err = ubi_io_read_hdrs(ubi, pnum, ech, &vid_err);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -915,7 +915,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	/* OK, we've done with the EC header, let's look at the VID header */
 
-	err = ubi_io_read_vid_hdr(ubi, pnum, vidh, 0);
+	err = vid_err;
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -1213,6 +1213,31 @@ static void destroy_ai(struct ubi_attach_info *ai)
 	kfree(ai);
 }
 
+/**
+ * alloc_scan_hdrs - allocate the header buffer used by 'scan_peb()'.
+ * @ubi: UBI device description object
+ *
+ * The EC and VID headers of a PEB are read at once into a single buffer, @ech
+ * points to its start and @vidh to the VID header inside of it.
+ */
+static int alloc_scan_hdrs(struct ubi_device *ubi)
+{
+	ech = kzalloc(ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize, GFP_KERNEL);
+	if (!ech)
+		return -ENOMEM;
+
+	vidh = (void *)ech + ubi->vid_hdr_aloffset + ubi->vid_hdr_shift;
+
+	return 0;
+}
+
+static void free_scan_hdrs(void)
+{
+	kfree(ech);
+	ech = NULL;
+	vidh = NULL;
+}
+
 /**
  * scan_all - scan entire MTD device.
  * @ubi: UBI device description object
@@ -1231,23 +1256,17 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	struct ubi_ainf_volume *av;
 	struct ubi_ainf_peb *aeb;
 
-	err = -ENOMEM;
-
-	ech = kzalloc(ubi->ec_hdr_alsize, GFP_KERNEL);
-	if (!ech)
+	err = alloc_scan_hdrs(ubi);
+	if (err)
 		return err;
 
-	vidh = ubi_zalloc_vid_hdr(ubi, GFP_KERNEL);
-	if (!vidh)
-		goto out_ech;
-
 	for (pnum = start; pnum < ubi->peb_count; pnum++) {
 		cond_resched();
 
 		dbg_gen("process PEB %d", pnum);
 		err = scan_peb(ubi, ai, pnum, NULL, NULL);
 		if (err < 0)
-			goto out_vidh;
+			goto out_hdrs;
 	}
 
 	ubi_msg(ubi, "scanning is finished");
@@ -1258,7 +1277,7 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	err = late_analysis(ubi, ai);
 	if (err)
-		goto out_vidh;
+		goto out_hdrs;
 
 	/*
 	 * In case of unknown erase counter we use the mean erase counter
@@ -1285,17 +1304,14 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	err = self_check_ai(ubi, ai);
 	if (err)
-		goto out_vidh;
+		goto out_hdrs;
 
-	ubi_free_vid_hdr(ubi, vidh);
-	kfree(ech);
+	free_scan_hdrs();
 
 	return 0;
 
-out_vidh:
-	ubi_free_vid_hdr(ubi, vidh);
-out_ech:
-	kfree(ech);
+out_hdrs:
+	free_scan_hdrs();
 	return err;
 }
 
@@ -1340,15 +1356,9 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 	int err, pnum, fm_anchor = -1;
 	unsigned long long max_sqnum = 0;
 
-	err = -ENOMEM;
-
-	ech = kzalloc(ubi->ec_hdr_alsize, GFP_KERNEL);
-	if (!ech)
-		goto out;
-
-	vidh = ubi_zalloc_vid_hdr(ubi, GFP_KERNEL);
-	if (!vidh)
-		goto out_ech;
+	err = alloc_scan_hdrs(ubi);
+	if (err)
+		return err;
 
 	for (pnum = 0; pnum < UBI_FM_MAX_START; pnum++) {
 		int vol_id = -1;
@@ -1357,8 +1367,10 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 
 		dbg_gen("process PEB %d", pnum);
 		err = scan_peb(ubi, *ai, pnum, &vol_id, &sqnum);
-		if (err < 0)
-			goto out_vidh;
+		if (err < 0) {
+			free_scan_hdrs();
+			return err;
+		}
 
 		if (vol_id == UBI_FM_SB_VOLUME_ID && sqnum > max_sqnum) {
 			max_sqnum = sqnum;
@@ -1366,8 +1378,7 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 		}
 	}
 
-	ubi_free_vid_hdr(ubi, vidh);
-	kfree(ech);
+	free_scan_hdrs();
 
 	if (fm_anchor < 0)
 		return UBI_NO_FASTMAP;
@@ -1378,13 +1389,6 @@ static int scan_fast(struct ubi_device *ubi, struct ubi_attach_info **ai)
 		return -ENOMEM;
 
 	return ubi_scan_fastmap(ubi, *ai, fm_anchor);
-
-out_vidh:
-	ubi_free_vid_hdr(ubi, vidh);
-out_ech:
-	kfree(ech);
-out:
-	return err;
 }
 
 #endif
@@ -1401,6 +1405,9 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 {
 	int err;
 	struct ubi_attach_info *ai;
+#ifdef __UBOOT__
+	ulong start = get_timer(0);
+#endif
 
 	ai = alloc_ai();
 	if (!ai)
@@ -1479,6 +1486,10 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 	}
 #endif
 
+#ifdef __UBOOT__
+	ubi_msg(ubi, "attached by %s in %lu ms", ubi->fm ? "fastmap" : "scanning",
+		get_timer(start));
+#endif
 	destroy_ai(ai);
 	return 0;
 
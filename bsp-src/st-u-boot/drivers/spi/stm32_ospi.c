@@ -13,7 +13,9 @@
 #include <spi-mem.h>
 #include <stm32_omi.h>
 #include <syscon.h>
+#include <asm/system.h>
 #include <dm/device_compat.h>
+#include <linux/bitfield.h>
 #include <linux/bitops.h>
 #include <linux/delay.h>
 #include <linux/sizes.h>
@@ -21,6 +23,11 @@
 #define NSEC_PER_SEC		1000000000L
 #define MACRONIX_ID		0xc2
 
+/* FIFO threshold allowing 32-bit accesses to the data register */
+#define STM32_OSPI_FIFO_THRES	3
+/* Memory-mapped reads from this size on are done through the data cache */
+#define STM32_OSPI_MM_CACHED_MIN	SZ_256K
+
 struct stm32_ospi_flash {
 	u64 str_idcode;
 	u64 dtr_idcode;
@@ -40,10 +47,31 @@ static int stm32_ospi_mm(struct udevice *omi_dev,
 			 const struct spi_mem_op *op)
 {
 	struct stm32_omi_plat *omi_plat = dev_get_plat(omi_dev);
+	phys_addr_t src = omi_plat->mm_base + op->addr.val;
+	phys_addr_t start, end;
 
-	memcpy_fromio(op->data.buf.in,
-		      (void __iomem *)omi_plat->mm_base + op->addr.val,
-		      op->data.nbytes);
+	if (!IS_ENABLED(CONFIG_ARM64) || !dcache_status() ||
+	    op->data.nbytes < STM32_OSPI_MM_CACHED_MIN) {
+		memcpy_fromio(op->data.buf.in, (void __iomem *)src,
+			      op->data.nbytes);
+
+		return 0;
+	}
+
+	/*
+	 * The memory-map area is mapped as device memory, so each load is a
+	 * separate bus access. For large reads, map the covered sections as
+	 * normal cacheable memory while memory-mapped mode is enabled: the
+	 * copy is then done by cache line bursts. The device mapping is
+	 * restored, and the cache lines dropped, before leaving the mode.
+	 */
+	start = ALIGN_DOWN(src, MMU_SECTION_SIZE);
+	end = min_t(phys_addr_t, ALIGN(src + op->data.nbytes, MMU_SECTION_SIZE),
+		    omi_plat->mm_base + omi_plat->mm_size);
+
+	mmu_set_region_dcache_behaviour(start, end - start, DCACHE_WRITEBACK);
+	memcpy(op->data.buf.in, (void *)src, op->data.nbytes);
+	mmu_set_region_dcache_behaviour(start, end - start, DCACHE_OFF);
 
 	return 0;
 }
@@ -495,28 +523,43 @@ static int stm32_ospi_dtr_calibration(struct udevice *bus)
 	return ret;
 }
 
+static int stm32_ospi_check_calibration(struct udevice *bus,
+					const struct spi_mem_op *op)
+{
+	struct stm32_ospi_priv *priv = dev_get_priv(bus);
+	struct stm32_omi_plat *omi_plat = dev_get_plat(priv->omi_dev);
+	struct stm32_ospi_flash *flash = &priv->flash[priv->cs_used];
+	phys_addr_t regs_base = omi_plat->regs_base;
+	int ret;
+
+	if (!op->cmd.dtr || flash->dtr_calibration_done_once)
+		return 0;
+
+	stm32_omi_dlyb_stop(priv->omi_dev);
+	clrbits_le32(regs_base + OSPI_TCR, OSPI_TCR_SSHIFT);
+	flash->octal_dtr = (op->cmd.nbytes == 2);
+
+	ret = stm32_ospi_dtr_calibration(bus);
+	if (ret)
+		return ret;
+
+	flash->dtr_calibration_done_once = true;
+
+	return 0;
+}
+
 static int stm32_ospi_exec_op(struct spi_slave *slave,
 			      const struct spi_mem_op *op)
 {
 	struct stm32_ospi_priv *priv = dev_get_priv(slave->dev->parent);
 	struct stm32_omi_plat *omi_plat = dev_get_plat(priv->omi_dev);
-	struct stm32_ospi_flash *flash = &priv->flash[priv->cs_used];
-	phys_addr_t regs_base = omi_plat->regs_base;
 	u32 addr_max;
 	u8 mode = OSPI_CCR_IND_WRITE;
 	int ret;
 
-	if (op->cmd.dtr && !flash->dtr_calibration_done_once) {
-		stm32_omi_dlyb_stop(priv->omi_dev);
-		clrbits_le32(regs_base + OSPI_TCR, OSPI_TCR_SSHIFT);
-		flash->octal_dtr = (op->cmd.nbytes == 2);
-
-		ret = stm32_ospi_dtr_calibration(slave->dev->parent);
-		if (ret)
-			return ret;
-
-		flash->dtr_calibration_done_once = true;
-	}
+	ret = stm32_ospi_check_calibration(slave->dev->parent, op);
+	if (ret)
+		return ret;
 
 	addr_max = op->addr.val + op->data.nbytes + 1;
 
@@ -530,6 +573,73 @@ static int stm32_ospi_exec_op(struct spi_slave *slave,
 	return stm32_ospi_send(priv->omi_dev, op, mode);
 }
 
+static int stm32_ospi_dirmap_create(struct spi_mem_dirmap_desc *desc)
+{
+	struct stm32_ospi_priv *priv = dev_get_priv(desc->slave->dev->parent);
+	struct stm32_omi_plat *omi_plat = dev_get_plat(priv->omi_dev);
+
+	/* Writes are done in indirect mode through exec_op() */
+	if (desc->info.op_tmpl.data.dir != SPI_MEM_DATA_IN)
+		return -EOPNOTSUPP;
+
+	if (!omi_plat->mm_size || !desc->info.op_tmpl.addr.buswidth)
+		return -EOPNOTSUPP;
+
+	return 0;
+}
+
+static ssize_t stm32_ospi_dirmap_read(struct spi_mem_dirmap_desc *desc,
+				      u64 offs, size_t len, void *buf)
+{
+	struct udevice *bus = desc->slave->dev->parent;
+	struct stm32_ospi_priv *priv = dev_get_priv(bus);
+	struct stm32_omi_plat *omi_plat = dev_get_plat(priv->omi_dev);
+	struct spi_mem_op op = desc->info.op_tmpl;
+	u8 mode = OSPI_CCR_MEM_MAP;
+	int ret;
+
+	/*
+	 * spi_mem_dirmap_read() doesn't claim the bus: enable the controller,
+	 * select the chip and apply its calibration as exec_op() callers get.
+	 */
+	ret = spi_claim_bus(desc->slave);
+	if (ret)
+		return ret;
+
+	ret = stm32_ospi_check_calibration(bus, &op);
+	if (ret)
+		goto out;
+
+	op.addr.val = desc->info.offset + offs;
+	op.data.buf.in = buf;
+	op.data.nbytes = len;
+
+	/*
+	 * Read what lies in the memory-map area, as stm32_ospi_exec_op()
+	 * does, and let the caller come back for the remaining part which is
+	 * then read in indirect mode.
+	 */
+	if (op.addr.val + 2 <= omi_plat->mm_size)
+		op.data.nbytes = min_t(u64, len,
+				       omi_plat->mm_size - op.addr.val - 2);
+	else
+		mode = OSPI_CCR_IND_READ;
+
+	if (!op.data.nbytes) {
+		op.data.nbytes = len;
+		mode = OSPI_CCR_IND_READ;
+	}
+
+	ret = stm32_ospi_send(priv->omi_dev, &op, mode);
+
+out:
+	spi_release_bus(desc->slave);
+	if (ret)
+		return ret;
+
+	return op.data.nbytes;
+}
+
 static int stm32_ospi_probe(struct udevice *bus)
 {
 	struct stm32_ospi_priv *priv = dev_get_priv(bus);
@@ -559,6 +669,10 @@ static int stm32_ospi_probe(struct udevice *bus)
 	/* Set dcr devsize to max address */
 	setbits_le32(regs_base + OSPI_DCR1, OSPI_DCR1_DEVSIZE_MASK);
 
+	/* Let stm32_omi_tx_poll() move 32-bit words through the FIFO */
+	clrsetbits_le32(regs_base + OSPI_CR, OSPI_CR_FTHRES_MASK,
+			FIELD_PREP(OSPI_CR_FTHRES_MASK, STM32_OSPI_FIFO_THRES));
+
 	priv->cs_used = -1;
 	omi_priv->check_transfer = stm32_ospi_readid;
 
@@ -719,6 +833,8 @@ static bool stm32_ospi_mem_supports_op(struct spi_slave *slave,
 static const struct spi_controller_mem_ops stm32_ospi_mem_ops = {
 	.exec_op = stm32_ospi_exec_op,
 	.supports_op = stm32_ospi_mem_supports_op,
+	.dirmap_create = stm32_ospi_dirmap_create,
+	.dirmap_read = stm32_ospi_dirmap_read,
 };
 
 static const struct dm_spi_ops stm32_ospi_ops = {
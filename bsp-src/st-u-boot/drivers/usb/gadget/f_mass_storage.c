@@ -276,6 +276,13 @@ static const char fsg_string_interface[] = "Mass Storage";
 
 #include "storage_common.c"
 
+/* Most buffers written to the medium at once, see do_write() */
+#define FSG_WRITE_RUN_MAX	(FSG_NUM_BUFFERS / 2)
+
+/* Size of the sequential read-ahead window, in sectors */
+#define FSG_RA_SECTORS \
+	(CONFIG_USB_GADGET_STORAGE_READ_AHEAD * 1024 / SECTOR_SIZE)
+
 /*-------------------------------------------------------------------------*/
 
 #define GFP_ATOMIC ((gfp_t) 0)
@@ -302,6 +309,7 @@ struct fsg_common {
 	struct fsg_buffhd	*next_buffhd_to_fill;
 	struct fsg_buffhd	*next_buffhd_to_drain;
 	struct fsg_buffhd	buffhds[FSG_NUM_BUFFERS];
+	void			*buffers;	/* Backing area of buffhds */
 
 	int			cmnd_size;
 	u8			cmnd[MAX_COMMAND_SIZE];
@@ -321,12 +329,20 @@ struct fsg_common {
 	u32			residue;
 	u32			usb_amount_left;
 
+	/* Sequential read-ahead window, see do_read() */
+	void			*ra_buf;
+	unsigned int		ra_lun;
+	u32			ra_lba;		/* First sector in ra_buf */
+	u32			ra_count;	/* Valid sectors in ra_buf */
+	u32			ra_next;	/* Sector after the last READ */
+
 	unsigned int		can_stall:1;
 	unsigned int		free_storage_on_release:1;
 	unsigned int		phase_error:1;
 	unsigned int		short_packet_received:1;
 	unsigned int		bad_lun_okay:1;
 	unsigned int		running:1;
+	unsigned int		ra_pending:1;
 
 	int			thread_wakeup_needed;
 	struct completion	thread_notifier;
@@ -689,12 +705,76 @@ static int sleep_thread(struct fsg_common *common)
 
 /*-------------------------------------------------------------------------*/
 
+/*
+ * Read sectors of the current LUN. The leading part is copied from the
+ * read-ahead window when it holds it. Returns the number of sectors read,
+ * like ums->read_sector().
+ */
+static int fsg_read_sectors(struct fsg_common *common, u32 lba, u32 count,
+			    void *buf)
+{
+	struct ums *ums_dev = &ums[common->lun];
+	u32 n = 0;
+	int rc;
+
+	if (common->ra_count && common->ra_lun == common->lun &&
+	    lba >= common->ra_lba && lba - common->ra_lba < common->ra_count) {
+		n = min(count, common->ra_lba + common->ra_count - lba);
+		memcpy(buf, common->ra_buf +
+		       (lba - common->ra_lba) * SECTOR_SIZE, n * SECTOR_SIZE);
+		if (n == count)
+			return n;
+	}
+
+	rc = ums_dev->read_sector(ums_dev, lba + n, count - n,
+				  buf + n * SECTOR_SIZE);
+	if (rc > 0)
+		rc += n;
+	else if (n)
+		rc = n;
+
+	return rc;
+}
+
+/*
+ * Refill the read-ahead window after a sequential READ, once its data and
+ * status are queued. The following READ commands are then served from
+ * memory, with one large device read instead of one per command.
+ */
+static void fsg_read_ahead(struct fsg_common *common)
+{
+	struct fsg_lun *curlun = &common->luns[common->ra_lun];
+	struct ums *ums_dev = &ums[common->ra_lun];
+	u32 lba = common->ra_next;
+	u32 count;
+	int rc;
+
+	common->ra_pending = 0;
+
+	/* The window still holds data past the last READ */
+	if (common->ra_count && lba >= common->ra_lba &&
+	    lba - common->ra_lba < common->ra_count)
+		return;
+
+	common->ra_count = 0;
+	count = min_t(u32, FSG_RA_SECTORS, curlun->num_sectors - lba);
+	if (!count)
+		return;
+
+	rc = ums_dev->read_sector(ums_dev, lba, count, common->ra_buf);
+	if (rc > 0) {
+		common->ra_lba = lba;
+		common->ra_count = rc;
+	}
+}
+
 static int do_read(struct fsg_common *common)
 {
 	struct fsg_lun		*curlun = &common->luns[common->lun];
 	u32			lba;
 	struct fsg_buffhd	*bh;
 	int			rc;
+	bool			sequential;
 	u32			amount_left;
 	loff_t			file_offset;
 	unsigned int		amount;
@@ -722,6 +802,10 @@ static int do_read(struct fsg_common *common)
 	}
 	file_offset = ((loff_t) lba) << 9;
 
+	/* Only read ahead once the host reads the LUN sequentially */
+	sequential = common->lun == common->ra_lun && lba == common->ra_next;
+	common->ra_pending = 0;
+
 	/* Carry out the file reads */
 	amount_left = common->data_size_from_cmnd;
 	if (unlikely(amount_left == 0))
@@ -763,8 +847,7 @@ static int do_read(struct fsg_common *common)
 		}
 
 		/* Perform the read */
-		rc = ums[common->lun].read_sector(&ums[common->lun],
-				      file_offset / SECTOR_SIZE,
+		rc = fsg_read_sectors(common, file_offset / SECTOR_SIZE,
 				      amount / SECTOR_SIZE,
 				      (char __user *)bh->buf);
 		if (!rc)
@@ -798,8 +881,14 @@ static int do_read(struct fsg_common *common)
 			break;
 		}
 
-		if (amount_left == 0)
+		if (amount_left == 0) {
+			if (common->ra_lun != common->lun)
+				common->ra_count = 0;
+			common->ra_lun = common->lun;
+			common->ra_next = file_offset / SECTOR_SIZE;
+			common->ra_pending = FSG_RA_SECTORS && sequential;
 			break;		/* No more left to read */
+		}
 
 		/* Send this buffer and go read some more */
 		bh->inreq->zero = 0;
@@ -816,18 +905,44 @@ static int do_read(struct fsg_common *common)
 
 /*-------------------------------------------------------------------------*/
 
+/*
+ * Count the received buffers, starting at @bh, that hold contiguous data
+ * both in memory and on the medium, so that they can be written at once.
+ * Return 0 when a transfer that would extend the run is still queued:
+ * it is worth waiting for it.
+ */
+static int fsg_write_run(struct fsg_buffhd *bh, unsigned int *amount)
+{
+	int n = 1;
+
+	*amount = bh->outreq->actual;
+	while (n < FSG_WRITE_RUN_MAX && !bh->outreq->status &&
+	       bh->outreq->actual == FSG_BUFLEN &&
+	       bh->next->buf == (char *)bh->buf + FSG_BUFLEN) {
+		bh = bh->next;
+		if (bh->state == BUF_STATE_BUSY)
+			return 0;
+		if (bh->state != BUF_STATE_FULL || bh->outreq->status)
+			break;
+		*amount += bh->outreq->actual;
+		n++;
+	}
+
+	return n;
+}
+
 static int do_write(struct fsg_common *common)
 {
 	struct fsg_lun		*curlun = &common->luns[common->lun];
 	u32			lba;
-	struct fsg_buffhd	*bh;
+	struct fsg_buffhd	*bh, *last;
 	int			get_some_more;
 	u32			amount_left_to_req, amount_left_to_write;
 	loff_t			usb_offset, file_offset;
 	unsigned int		amount;
 	unsigned int		partial_page;
 	ssize_t			nwritten;
-	int			rc;
+	int			rc, nbufs;
 
 	if (curlun->ro) {
 		curlun->sense_data = SS_WRITE_PROTECTED;
@@ -855,6 +970,10 @@ static int do_write(struct fsg_common *common)
 		return -EINVAL;
 	}
 
+	/* The medium changes under the read-ahead window */
+	if (common->ra_lun == common->lun)
+		common->ra_count = 0;
+
 	/* Carry out the file writes */
 	get_some_more = 1;
 	file_offset = usb_offset = ((loff_t) lba) << 9;
@@ -924,8 +1043,21 @@ static int do_write(struct fsg_common *common)
 		if (bh->state == BUF_STATE_EMPTY && !get_some_more)
 			break;			/* We stopped early */
 		if (bh->state == BUF_STATE_FULL) {
-			common->next_buffhd_to_drain = bh->next;
-			bh->state = BUF_STATE_EMPTY;
+			nbufs = fsg_write_run(bh, &amount);
+			if (!nbufs) {
+				rc = sleep_thread(common);
+				if (rc)
+					return rc;
+				continue;
+			}
+
+			last = bh;
+			last->state = BUF_STATE_EMPTY;
+			while (--nbufs) {
+				last = last->next;
+				last->state = BUF_STATE_EMPTY;
+			}
+			common->next_buffhd_to_drain = last->next;
 
 			/* Did something go wrong with the transfer? */
 			if (bh->outreq->status != 0) {
@@ -934,8 +1066,6 @@ static int do_write(struct fsg_common *common)
 				break;
 			}
 
-			amount = bh->outreq->actual;
-
 			/* Perform the write */
 			rc = ums[common->lun].write_sector(&ums[common->lun],
 					       file_offset / SECTOR_SIZE,
@@ -973,7 +1103,7 @@ static int do_write(struct fsg_common *common)
 			}
 
 			/* Did the host decide to stop early? */
-			if (bh->outreq->actual != bh->outreq->length) {
+			if (last->outreq->actual != last->outreq->length) {
 				common->short_packet_received = 1;
 				break;
 			}
@@ -2426,6 +2556,9 @@ int fsg_main_thread(void *common_)
 		if (send_status(common))
 			continue;
 
+		if (common->ra_pending)
+			fsg_read_ahead(common);
+
 		if (!exception_in_progress(common))
 			common->state = FSG_STATE_IDLE;
 	} while (0);
@@ -2497,7 +2630,14 @@ static struct fsg_common *fsg_common_init(struct fsg_common *common,
 	}
 	common->lun = 0;
 
-	/* Data buffers cyclic list */
+	/* Data buffers cyclic list, in one area so that do_write() can
+	 * write consecutive buffers at once */
+	common->buffers = memalign(CONFIG_SYS_CACHELINE_SIZE,
+				   FSG_NUM_BUFFERS * FSG_BUFLEN);
+	if (unlikely(!common->buffers)) {
+		rc = -ENOMEM;
+		goto error_release;
+	}
 	bh = common->buffhds;
 
 	i = FSG_NUM_BUFFERS;
@@ -2508,13 +2648,18 @@ static struct fsg_common *fsg_common_init(struct fsg_common *common,
 buffhds_first_it:
 		bh->inreq_busy = 0;
 		bh->outreq_busy = 0;
-		bh->buf = memalign(CONFIG_SYS_CACHELINE_SIZE, FSG_BUFLEN);
-		if (unlikely(!bh->buf)) {
+		bh->buf = common->buffers + (bh - common->buffhds) * FSG_BUFLEN;
+	} while (--i);
+	bh->next = common->buffhds;
+
+	if (FSG_RA_SECTORS) {
+		common->ra_buf = memalign(CONFIG_SYS_CACHELINE_SIZE,
+					  FSG_RA_SECTORS * SECTOR_SIZE);
+		if (unlikely(!common->ra_buf)) {
 			rc = -ENOMEM;
 			goto error_release;
 		}
-	} while (--i);
-	bh->next = common->buffhds;
+	}
 
 	snprintf(common->inquiry_string, sizeof common->inquiry_string,
 		 "%-8s%-16s%04x",
@@ -2574,13 +2719,8 @@ static void fsg_common_release(struct kref *ref)
 		kfree(common->luns);
 	}
 
-	{
-		struct fsg_buffhd *bh = common->buffhds;
-		unsigned i = FSG_NUM_BUFFERS;
-		do {
-			kfree(bh->buf);
-		} while (++bh, --i);
-	}
+	kfree(common->buffers);
+	kfree(common->ra_buf);
 
 	if (common->free_storage_on_release)
 		kfree(common);
@@ -173,11 +173,16 @@ static int erofs_read_raw_data(struct erofs_inode *inode, char *buffer,
 	struct erofs_map_blocks map = {
 		.index = UINT_MAX,
 	};
+	/* pending read, extended as long as extents are contiguous on disk */
+	struct erofs_map_dev run = { 0 };
+	erofs_off_t run_len = 0;
+	char *run_buf = NULL;
 	int ret;
 	erofs_off_t ptr = offset;
 
 	while (ptr < offset + size) {
 		char *const estart = buffer + ptr - offset;
+		struct erofs_map_dev mdev;
 		erofs_off_t eend, moff = 0;
 
 		map.m_la = ptr;
@@ -208,11 +213,60 @@ static int erofs_read_raw_data(struct erofs_inode *inode, char *buffer,
 			map.m_la = ptr;
 		}
 
-		ret = erofs_read_one_data(&map, estart, moff, eend - map.m_la);
+		mdev = (struct erofs_map_dev) {
+			.m_deviceid = map.m_deviceid,
+			.m_pa = map.m_pa,
+		};
+		ret = erofs_map_dev(&mdev);
 		if (ret)
 			return ret;
+		mdev.m_pa += moff;
+
+		if (run_len && mdev.m_deviceid == run.m_deviceid &&
+		    mdev.m_pa == run.m_pa + run_len &&
+		    estart == run_buf + run_len) {
+			run_len += eend - map.m_la;
+		} else {
+			if (run_len &&
+			    erofs_dev_read(run.m_deviceid, run_buf, run.m_pa,
+					   run_len) < 0)
+				return -EIO;
+
+			run = mdev;
+			run_buf = estart;
+			run_len = eend - map.m_la;
+		}
 		ptr = eend;
 	}
+
+	if (run_len &&
+	    erofs_dev_read(run.m_deviceid, run_buf, run.m_pa, run_len) < 0)
+		return -EIO;
+	return 0;
+}
+
+static int z_erofs_decompress_data(struct erofs_map_blocks *map, char *raw,
+				   char *buffer, erofs_off_t skip,
+				   erofs_off_t length, bool trimmed)
+{
+	int ret;
+
+	ret = z_erofs_decompress(&(struct z_erofs_decompress_req) {
+			.in = raw,
+			.out = buffer,
+			.decodedskip = skip,
+			.interlaced_offset =
+				map->m_algorithmformat == Z_EROFS_COMPRESSION_INTERLACED ?
+					erofs_blkoff(map->m_la) : 0,
+			.inputsize = map->m_plen,
+			.decodedlength = length,
+			.alg = map->m_algorithmformat,
+			.partial_decoding = trimmed ? true :
+				!(map->m_flags & EROFS_MAP_FULL_MAPPED) ||
+					(map->m_flags & EROFS_MAP_PARTIAL_REF),
+			 });
+	if (ret < 0)
+		return ret;
 	return 0;
 }
 
@@ -252,22 +306,195 @@ int z_erofs_read_one_data(struct erofs_inode *inode,
 	if (ret < 0)
 		return ret;
 
-	ret = z_erofs_decompress(&(struct z_erofs_decompress_req) {
-			.in = raw,
-			.out = buffer,
-			.decodedskip = skip,
-			.interlaced_offset =
-				map->m_algorithmformat == Z_EROFS_COMPRESSION_INTERLACED ?
-					erofs_blkoff(map->m_la) : 0,
-			.inputsize = map->m_plen,
-			.decodedlength = length,
-			.alg = map->m_algorithmformat,
-			.partial_decoding = trimmed ? true :
-				!(map->m_flags & EROFS_MAP_FULL_MAPPED) ||
-					(map->m_flags & EROFS_MAP_PARTIAL_REF),
-			 });
+	return z_erofs_decompress_data(map, raw, buffer, skip, length, trimmed);
+}
+
+/*
+ * Compressed data of the extents read by z_erofs_read_data(), fetched from
+ * the device in as few reads as possible.
+ */
+struct z_erofs_raw_batch {
+	/* used to map the extents preceding the one being read */
+	struct erofs_map_blocks *prev;
+	char *raw;
+	erofs_off_t pa;
+	unsigned int len, bufsize;
+};
+
+/*
+ * Extents are decompressed backwards, while their pclusters are usually
+ * stored in increasing order. Return the start of the physically contiguous
+ * pclusters ending with the one of @map, limited to the requested range.
+ */
+static erofs_off_t z_erofs_batch_start(struct erofs_inode *inode,
+				       struct erofs_map_blocks *map,
+				       struct z_erofs_raw_batch *batch,
+				       erofs_off_t offset)
+{
+	erofs_off_t pa = map->m_pa, la = map->m_la;
+	struct erofs_map_blocks *prev;
+
+	/* a read must not cross the boundary between two devices */
+	if (sbi.extra_devices)
+		return pa;
+
+	if (!batch->prev) {
+		batch->prev = calloc(1, sizeof(*batch->prev));
+		if (!batch->prev)
+			return pa;
+		batch->prev->index = UINT_MAX;
+	}
+	prev = batch->prev;
+
+	while (la > offset) {
+		prev->m_la = la - 1;
+		if (z_erofs_map_blocks_iter(inode, prev, 0))
+			break;
+
+		if ((prev->m_flags & (EROFS_MAP_MAPPED | EROFS_MAP_META |
+				      EROFS_MAP_FRAGMENT)) != EROFS_MAP_MAPPED ||
+		    prev->m_pa + prev->m_plen != pa ||
+		    map->m_pa + map->m_plen - prev->m_pa > Z_EROFS_READ_BATCH_SIZE)
+			break;
+
+		pa = prev->m_pa;
+		la = prev->m_la;
+	}
+	return pa;
+}
+
+static int z_erofs_fetch_raw(struct erofs_inode *inode,
+			     struct erofs_map_blocks *map,
+			     struct z_erofs_raw_batch *batch,
+			     erofs_off_t offset, char **raw)
+{
+	struct erofs_map_dev mdev;
+	erofs_off_t start;
+	unsigned int len;
+	int ret;
+
+	if (batch->len && map->m_pa >= batch->pa &&
+	    map->m_pa + map->m_plen <= batch->pa + batch->len) {
+		*raw = batch->raw + (map->m_pa - batch->pa);
+		return 0;
+	}
+
+	start = z_erofs_batch_start(inode, map, batch, offset);
+	len = map->m_pa + map->m_plen - start;
+	if (len > batch->bufsize) {
+		free(batch->raw);
+		batch->len = 0;
+		batch->raw = malloc(len);
+		if (!batch->raw) {
+			batch->bufsize = 0;
+			return -ENOMEM;
+		}
+		batch->bufsize = len;
+	}
+
+	mdev = (struct erofs_map_dev) {
+		.m_pa = start,
+	};
+	ret = erofs_map_dev(&mdev);
+	if (ret) {
+		DBG_BUGON(1);
+		return ret;
+	}
+
+	ret = erofs_dev_read(mdev.m_deviceid, batch->raw, mdev.m_pa, len);
+	if (ret < 0) {
+		batch->len = 0;
+		return ret;
+	}
+
+	batch->pa = start;
+	batch->len = len;
+	*raw = batch->raw + (map->m_pa - start);
+	return 0;
+}
+
+/*
+ * Recently decompressed pclusters. Partial reads, such as directory blocks or
+ * the file tails stored in the packed inode, often hit the same pcluster
+ * several times in a row.
+ */
+static struct z_erofs_pcluster_cache {
+	erofs_off_t pa;
+	unsigned int interlaced_offset;
+	char alg;
+	unsigned int len, bufsize;
+	unsigned int last_use;
+	char *data;
+} z_erofs_pcache[Z_EROFS_PCLUSTER_CACHE_ENTRIES];
+static unsigned int z_erofs_pcache_tick;
+
+void z_erofs_release_cache(void)
+{
+	int i;
+
+	for (i = 0; i < Z_EROFS_PCLUSTER_CACHE_ENTRIES; i++) {
+		free(z_erofs_pcache[i].data);
+		z_erofs_pcache[i] = (struct z_erofs_pcluster_cache) { 0 };
+	}
+	z_erofs_pcache_tick = 0;
+}
+
+/* decompress the whole extent once, then serve the requested part of it */
+static int z_erofs_read_cached(struct erofs_inode *inode,
+			       struct erofs_map_blocks *map,
+			       struct z_erofs_raw_batch *batch,
+			       erofs_off_t offset, char *buffer,
+			       erofs_off_t skip, erofs_off_t length)
+{
+	struct z_erofs_pcluster_cache *pc, *victim = &z_erofs_pcache[0];
+	unsigned int ileave = 0;
+	char *raw;
+	int i, ret;
+
+	if (map->m_algorithmformat == Z_EROFS_COMPRESSION_INTERLACED)
+		ileave = erofs_blkoff(map->m_la);
+
+	for (i = 0; i < Z_EROFS_PCLUSTER_CACHE_ENTRIES; i++) {
+		pc = &z_erofs_pcache[i];
+		if (pc->len && pc->pa == map->m_pa &&
+		    pc->alg == map->m_algorithmformat &&
+		    pc->interlaced_offset == ileave && pc->len >= length)
+			goto hit;
+
+		if (!pc->len)
+			victim = pc;
+		else if (victim->len && pc->last_use < victim->last_use)
+			victim = pc;
+	}
+
+	pc = victim;
+	pc->len = 0;
+	if (map->m_llen > pc->bufsize) {
+		free(pc->data);
+		pc->data = malloc(map->m_llen);
+		if (!pc->data) {
+			pc->bufsize = 0;
+			return -ENOMEM;
+		}
+		pc->bufsize = map->m_llen;
+	}
+
+	ret = z_erofs_fetch_raw(inode, map, batch, offset, &raw);
 	if (ret < 0)
 		return ret;
+
+	ret = z_erofs_decompress_data(map, raw, pc->data, 0, map->m_llen,
+				      false);
+	if (ret < 0)
+		return ret;
+
+	pc->pa = map->m_pa;
+	pc->alg = map->m_algorithmformat;
+	pc->interlaced_offset = ileave;
+	pc->len = map->m_llen;
+hit:
+	pc->last_use = ++z_erofs_pcache_tick;
+	memcpy(buffer, pc->data + skip, length - skip);
 	return 0;
 }
 
@@ -278,9 +505,9 @@ static int z_erofs_read_data(struct erofs_inode *inode, char *buffer,
 	struct erofs_map_blocks map = {
 		.index = UINT_MAX,
 	};
+	struct z_erofs_raw_batch batch = { 0 };
 	bool trimmed;
-	unsigned int bufsize = 0;
-	char *raw = NULL;
+	char *raw;
 	int ret = 0;
 
 	end = offset + size;
@@ -318,23 +545,29 @@ static int z_erofs_read_data(struct erofs_inode *inode, char *buffer,
 			continue;
 		}
 
-		if (map.m_plen > bufsize) {
-			bufsize = map.m_plen;
-			raw = realloc(raw, bufsize);
-			if (!raw) {
-				ret = -ENOMEM;
+		if (map.m_flags & EROFS_MAP_FRAGMENT) {
+			ret = z_erofs_read_one_data(inode, &map, NULL,
+						    buffer + end - offset,
+						    skip, length, trimmed);
+		} else if (skip || trimmed) {
+			ret = z_erofs_read_cached(inode, &map, &batch, offset,
+						  buffer + end - offset,
+						  skip, length);
+		} else {
+			/* the whole extent is wanted, decode it in place */
+			ret = z_erofs_fetch_raw(inode, &map, &batch, offset,
+						&raw);
+			if (ret < 0)
 				break;
-			}
+			ret = z_erofs_decompress_data(&map, raw,
+						      buffer + end - offset,
+						      0, length, false);
 		}
-
-		ret = z_erofs_read_one_data(inode, &map, raw,
-					    buffer + end - offset, skip, length,
-					    trimmed);
 		if (ret < 0)
 			break;
 	}
-	if (raw)
-		free(raw);
+	free(batch.raw);
+	free(batch.prev);
 	return ret < 0 ? ret : 0;
 }
 
@@ -35,6 +35,11 @@
 #define EROFS_MAX_BLOCK_SIZE	PAGE_SIZE
 #endif
 
+/* upper bound of the compressed data fetched with a single device read */
+#define Z_EROFS_READ_BATCH_SIZE		(1024 * 1024)
+/* number of decompressed pclusters kept for partial reads */
+#define Z_EROFS_PCLUSTER_CACHE_ENTRIES	4
+
 #define EROFS_ISLOTBITS		5
 #define EROFS_SLOTSIZE		(1U << EROFS_ISLOTBITS)
 
@@ -344,6 +349,7 @@ int erofs_read_one_data(struct erofs_map_blocks *map, char *buffer, u64 offset,
 int z_erofs_read_one_data(struct erofs_inode *inode,
 			  struct erofs_map_blocks *map, char *raw, char *buffer,
 			  erofs_off_t skip, erofs_off_t length, bool trimmed);
+void z_erofs_release_cache(void);
 
 static inline int erofs_get_occupied_size(const struct erofs_inode *inode,
 					  erofs_off_t *size)
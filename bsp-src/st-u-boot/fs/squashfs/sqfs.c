@@ -878,13 +878,70 @@ out:
 	return metablks_count;
 }
 
+/*
+ * Decompress the inode and directory tables on first use. They are shared by
+ * every directory stream and file lookup until another filesystem is probed.
+ */
+static int sqfs_load_tables(void)
+{
+	int ret;
+
+	if (!ctxt.inode_table) {
+		ret = sqfs_read_inode_table(&ctxt.inode_table);
+		if (ret)
+			return ret;
+	}
+
+	if (!ctxt.dir_table) {
+		ret = sqfs_read_directory_table(&ctxt.dir_table,
+						&ctxt.dir_pos_list);
+		if (ret < 1)
+			return -EINVAL;
+
+		ctxt.dir_metablks_count = ret;
+	}
+
+	return 0;
+}
+
+static void sqfs_free_cache(void)
+{
+	int i;
+
+	free(ctxt.inode_table);
+	free(ctxt.dir_table);
+	free(ctxt.dir_pos_list);
+	ctxt.inode_table = NULL;
+	ctxt.dir_table = NULL;
+	ctxt.dir_pos_list = NULL;
+	ctxt.dir_metablks_count = 0;
+
+	for (i = 0; i < SQFS_FRAG_CACHE_ENTRIES; i++) {
+		free(ctxt.frag_cache[i].data);
+		ctxt.frag_cache[i].data = NULL;
+	}
+	ctxt.frag_cache_tick = 0;
+}
+
+void sqfs_cache_invalidate(struct blk_desc *dev_desc, lbaint_t start,
+			   lbaint_t blkcnt)
+{
+	if (dev_desc != ctxt.cache_dev || dev_desc->hwpart != ctxt.cache_hwpart)
+		return;
+
+	if (start >= ctxt.cache_part_start + ctxt.cache_part_size ||
+	    start + blkcnt <= ctxt.cache_part_start)
+		return;
+
+	sqfs_free_cache();
+	ctxt.cache_dev = NULL;
+}
+
 int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
 {
-	unsigned char *inode_table = NULL, *dir_table = NULL;
-	int j, token_count = 0, ret = 0, metablks_count;
+	int j, token_count = 0, ret = 0;
 	struct squashfs_dir_stream *dirs;
 	char **token_list = NULL, *path = NULL;
-	u32 *pos_list = NULL;
 
 	dirs = calloc(1, sizeof(*dirs));
 	if (!dirs)
@@ -897,18 +954,12 @@ int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
 	dirs->inode_table = NULL;
 	dirs->dir_table = NULL;
 
-	ret = sqfs_read_inode_table(&inode_table);
+	ret = sqfs_load_tables();
 	if (ret) {
 		ret = -EINVAL;
 		goto out;
 	}
 
-	metablks_count = sqfs_read_directory_table(&dir_table, &pos_list);
-	if (metablks_count < 1) {
-		ret = -EINVAL;
-		goto out;
-	}
-
 	/* Tokenize filename */
 	token_count = sqfs_count_tokens(filename);
 	if (token_count < 0) {
@@ -936,10 +987,10 @@ int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
 	 * ldir's (extended directory) size is greater than dir, so it works as
 	 * a general solution for the malloc size, since 'i' is a union.
 	 */
-	dirs->inode_table = inode_table;
-	dirs->dir_table = dir_table;
-	ret = sqfs_search_dir(dirs, token_list, token_count, pos_list,
-			      metablks_count);
+	dirs->inode_table = ctxt.inode_table;
+	dirs->dir_table = ctxt.dir_table;
+	ret = sqfs_search_dir(dirs, token_list, token_count, ctxt.dir_pos_list,
+			      ctxt.dir_metablks_count);
 	if (ret)
 		goto out;
 
@@ -963,12 +1014,9 @@ out:
 	for (j = 0; j < token_count; j++)
 		free(token_list[j]);
 	free(token_list);
-	free(pos_list);
 	free(path);
-	if (ret) {
-		free(inode_table);
+	if (ret)
 		free(dirs);
-	}
 
 	return ret;
 }
@@ -1107,6 +1155,20 @@ int sqfs_probe(struct blk_desc *fs_dev_desc, struct disk_partition *fs_partition
 		goto error;
 	}
 
+	/* Tables cached for another filesystem must not be reused */
+	if (ctxt.cache_dev != fs_dev_desc ||
+	    ctxt.cache_hwpart != fs_dev_desc->hwpart ||
+	    ctxt.cache_part_start != fs_partition->start ||
+	    ctxt.cache_part_size != fs_partition->size ||
+	    memcmp(&ctxt.cache_sblk, sblk, sizeof(*sblk))) {
+		sqfs_free_cache();
+		ctxt.cache_dev = fs_dev_desc;
+		ctxt.cache_hwpart = fs_dev_desc->hwpart;
+		ctxt.cache_part_start = fs_partition->start;
+		ctxt.cache_part_size = fs_partition->size;
+		ctxt.cache_sblk = *sblk;
+	}
+
 	ctxt.sblk = sblk;
 
 	ret = sqfs_decompressor_init(&ctxt);
@@ -1317,13 +1379,98 @@ static int sqfs_get_lregfile_info(struct squashfs_lreg_inode *lreg,
 	return datablk_count;
 }
 
+/*
+ * Return the decompressed fragment block described by 'e'. Files packed in
+ * the same fragment block are often read in a row, so the last blocks are kept
+ * and only read back from the medium on a miss.
+ */
+static int sqfs_get_fragment(const struct squashfs_fragment_block_entry *e,
+			     bool comp, char **block, u32 *block_len)
+{
+	struct squashfs_frag_cache *entry, *victim = &ctxt.frag_cache[0];
+	u32 block_size = get_unaligned_le32(&ctxt.sblk->block_size);
+	u64 start, n_blks, table_size, table_offset;
+	unsigned long dest_len;
+	char *fragment;
+	int i, ret;
+
+	for (i = 0; i < SQFS_FRAG_CACHE_ENTRIES; i++) {
+		entry = &ctxt.frag_cache[i];
+		if (entry->data && entry->start == e->start) {
+			entry->last_use = ++ctxt.frag_cache_tick;
+			*block = entry->data;
+			*block_len = entry->size;
+			return 0;
+		}
+
+		if (!entry->data)
+			victim = entry;
+		else if (victim->data && entry->last_use < victim->last_use)
+			victim = entry;
+	}
+
+	start = lldiv(e->start, ctxt.cur_dev->blksz);
+	table_size = SQFS_BLOCK_SIZE(e->size);
+	table_offset = e->start - (start * ctxt.cur_dev->blksz);
+	n_blks = DIV_ROUND_UP(table_size + table_offset, ctxt.cur_dev->blksz);
+
+	if (!comp && table_size > block_size)
+		return -EINVAL;
+
+	fragment = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
+	if (!fragment)
+		return -ENOMEM;
+
+	ret = sqfs_disk_read(start, n_blks, fragment);
+	if (ret < 0)
+		goto out;
+
+	if (!victim->data) {
+		victim->data = malloc(block_size);
+		if (!victim->data) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+
+	if (comp) {
+		dest_len = block_size;
+		ret = sqfs_decompress(&ctxt, victim->data, &dest_len,
+				      fragment + table_offset, table_size);
+		if (ret) {
+			free(victim->data);
+			victim->data = NULL;
+			goto out;
+		}
+	} else {
+		memcpy(victim->data, fragment + table_offset, table_size);
+		dest_len = table_size;
+	}
+
+	victim->start = e->start;
+	victim->size = dest_len;
+	victim->last_use = ++ctxt.frag_cache_tick;
+	*block = victim->data;
+	*block_len = dest_len;
+	ret = 0;
+
+out:
+	free(fragment);
+
+	return ret;
+}
+
 int sqfs_read(const char *filename, void *buf, loff_t offset, loff_t len,
 	      loff_t *actread)
 {
 	char *dir = NULL, *fragment_block, *datablock = NULL;
-	char *fragment = NULL, *file = NULL, *resolved, *data;
+	char *data_buffer = NULL, *file = NULL, *resolved, *data;
 	u64 start, n_blks, table_size, data_offset, table_offset, sparse_size;
-	int ret, j, i_number, datablk_count = 0;
+	u64 batch_size, buffer_blks = 0, remaining;
+	int ret, i, j, k, i_number, datablk_count = 0;
+	u32 block_size, frag_len;
+	bool truncated = false;
+	void *dest;
 	struct squashfs_super_block *sblk = ctxt.sblk;
 	struct squashfs_fragment_block_entry frag_entry;
 	struct squashfs_file_info finfo = {0};
@@ -1435,144 +1582,149 @@ int sqfs_read(const char *filename, void *buf, loff_t offset, loff_t len,
 			goto out;
 		}
 
+		truncated = len < finfo.size;
 		finfo.size = len;
 	} else {
 		len = finfo.size;
 	}
 
-	if (datablk_count) {
-		data_offset = finfo.start;
-		datablock = malloc(get_unaligned_le32(&sblk->block_size));
+	block_size = get_unaligned_le32(&sblk->block_size);
+	data_offset = finfo.start;
+
+	/*
+	 * Only a block cut by the requested length needs an intermediate
+	 * buffer, all the others are decompressed in place.
+	 */
+	if (datablk_count && truncated) {
+		datablock = malloc(block_size);
 		if (!datablock) {
 			ret = -ENOMEM;
 			goto out;
 		}
 	}
 
-	for (j = 0; j < datablk_count; j++) {
-		char *data_buffer;
+	j = 0;
+	while (j < datablk_count && *actread < len) {
+		/* Don't load any data for sparse blocks */
+		if (finfo.blk_sizes[j] == 0) {
+			sparse_size = block_size;
+			if ((*actread + sparse_size) > len)
+				sparse_size = len - *actread;
+			memset(buf + *actread, 0, sparse_size);
+			*actread += sparse_size;
+			j++;
+			continue;
+		}
+
+		/*
+		 * Data blocks are stored back to back: fetch the following
+		 * non-sparse ones, up to the requested length, in one go.
+		 */
+		remaining = len - *actread;
+		batch_size = 0;
+		k = j;
+		do {
+			batch_size += SQFS_BLOCK_SIZE(finfo.blk_sizes[k]);
+			k++;
+		} while (k < datablk_count && finfo.blk_sizes[k] &&
+			 (u64)(k - j) * block_size < remaining &&
+			 batch_size + SQFS_BLOCK_SIZE(finfo.blk_sizes[k]) <=
+			 SQFS_DATA_BATCH_SIZE);
 
 		start = lldiv(data_offset, ctxt.cur_dev->blksz);
-		table_size = SQFS_BLOCK_SIZE(finfo.blk_sizes[j]);
 		table_offset = data_offset - (start * ctxt.cur_dev->blksz);
-		n_blks = DIV_ROUND_UP(table_size + table_offset,
+		n_blks = DIV_ROUND_UP(batch_size + table_offset,
 				      ctxt.cur_dev->blksz);
 
-		/* Don't load any data for sparse blocks */
-		if (finfo.blk_sizes[j] == 0) {
-			n_blks = 0;
-			table_offset = 0;
-			data_buffer = NULL;
-			data = NULL;
-		} else {
-			data_buffer = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
-
+		if (n_blks > buffer_blks) {
+			free(data_buffer);
+			data_buffer = malloc_cache_aligned(n_blks *
+							   ctxt.cur_dev->blksz);
 			if (!data_buffer) {
 				ret = -ENOMEM;
 				goto out;
 			}
+			buffer_blks = n_blks;
+		}
 
-			ret = sqfs_disk_read(start, n_blks, data_buffer);
-			if (ret < 0) {
-				/*
-				 * Possible causes: too many data blocks or too large
-				 * SquashFS block size. Tip: re-compile the SquashFS
-				 * image with mksquashfs's -b <block_size> option.
-				 */
-				printf("Error: too many data blocks to be read.\n");
-				goto out;
-			}
-
-			data = data_buffer + table_offset;
+		ret = sqfs_disk_read(start, n_blks, data_buffer);
+		if (ret < 0) {
+			/*
+			 * Possible causes: too many data blocks or too large
+			 * SquashFS block size. Tip: re-compile the SquashFS
+			 * image with mksquashfs's -b <block_size> option.
+			 */
+			printf("Error: too many data blocks to be read.\n");
+			goto out;
 		}
 
+		data = data_buffer + table_offset;
+
 		/* Load the data */
-		if (finfo.blk_sizes[j] == 0) {
-			/* This is a sparse block */
-			sparse_size = get_unaligned_le32(&sblk->block_size);
-			if ((*actread + sparse_size) > len)
-				sparse_size = len - *actread;
-			memset(buf + *actread, 0, sparse_size);
-			*actread += sparse_size;
-		} else if (SQFS_COMPRESSED_BLOCK(finfo.blk_sizes[j])) {
-			dest_len = get_unaligned_le32(&sblk->block_size);
-			ret = sqfs_decompress(&ctxt, datablock, &dest_len,
-					      data, table_size);
-			if (ret)
-				goto out;
+		for (i = j; i < k && *actread < len; i++) {
+			table_size = SQFS_BLOCK_SIZE(finfo.blk_sizes[i]);
+			remaining = len - *actread;
+
+			if (SQFS_COMPRESSED_BLOCK(finfo.blk_sizes[i])) {
+				if (remaining >= block_size || !truncated) {
+					dest = buf + *actread;
+					dest_len = min_t(u64, remaining,
+							 block_size);
+				} else {
+					dest = datablock;
+					dest_len = block_size;
+				}
+
+				ret = sqfs_decompress(&ctxt, dest, &dest_len,
+						      data, table_size);
+				if (ret)
+					goto out;
+
+				if (dest_len > remaining)
+					dest_len = remaining;
+				if (dest == datablock)
+					memcpy(buf + *actread, datablock,
+					       dest_len);
+				*actread += dest_len;
+			} else {
+				dest_len = min_t(u64, remaining, table_size);
+				memcpy(buf + *actread, data, dest_len);
+				*actread += dest_len;
+			}
 
-			if ((*actread + dest_len) > len)
-				dest_len = len - *actread;
-			memcpy(buf + *actread, datablock, dest_len);
-			*actread += dest_len;
-		} else {
-			if ((*actread + table_size) > len)
-				table_size = len - *actread;
-			memcpy(buf + *actread, data, table_size);
-			*actread += table_size;
+			data += table_size;
+			data_offset += table_size;
 		}
 
-		data_offset += table_size;
-		free(data_buffer);
-		if (*actread >= len)
-			break;
+		j = k;
 	}
 
 	/*
-	 * There is no need to continue if the file is not fragmented.
+	 * There is no need to continue if the file is not fragmented, or if
+	 * the requested length is already read.
 	 */
-	if (!finfo.frag) {
+	if (!finfo.frag || *actread >= len) {
 		ret = 0;
 		goto out;
 	}
 
-	start = lldiv(frag_entry.start, ctxt.cur_dev->blksz);
-	table_size = SQFS_BLOCK_SIZE(frag_entry.size);
-	table_offset = frag_entry.start - (start * ctxt.cur_dev->blksz);
-	n_blks = DIV_ROUND_UP(table_size + table_offset, ctxt.cur_dev->blksz);
-
-	fragment = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
-
-	if (!fragment) {
-		ret = -ENOMEM;
+	ret = sqfs_get_fragment(&frag_entry, finfo.comp, &fragment_block,
+				&frag_len);
+	if (ret)
 		goto out;
-	}
 
-	ret = sqfs_disk_read(start, n_blks, fragment);
-	if (ret < 0)
+	if (finfo.offset > frag_len ||
+	    finfo.size - *actread > frag_len - finfo.offset) {
+		ret = -EINVAL;
 		goto out;
-
-	/* File compressed and fragmented */
-	if (finfo.frag && finfo.comp) {
-		dest_len = get_unaligned_le32(&sblk->block_size);
-		fragment_block = malloc(dest_len);
-		if (!fragment_block) {
-			ret = -ENOMEM;
-			goto out;
-		}
-
-		ret = sqfs_decompress(&ctxt, fragment_block, &dest_len,
-				      (void *)fragment  + table_offset,
-				      frag_entry.size);
-		if (ret) {
-			free(fragment_block);
-			goto out;
-		}
-
-		memcpy(buf + *actread, &fragment_block[finfo.offset], finfo.size - *actread);
-		*actread = finfo.size;
-
-		free(fragment_block);
-
-	} else if (finfo.frag && !finfo.comp) {
-		fragment_block = (void *)fragment + table_offset;
-
-		memcpy(buf + *actread, &fragment_block[finfo.offset], finfo.size - *actread);
-		*actread = finfo.size;
 	}
 
+	memcpy(buf + *actread, &fragment_block[finfo.offset],
+	       finfo.size - *actread);
+	*actread = finfo.size;
+
 out:
-	free(fragment);
+	free(data_buffer);
 	free(datablock);
 	free(file);
 	free(dir);
@@ -1725,8 +1877,6 @@ void sqfs_closedir(struct fs_dir_stream *dirs)
 		return;
 
 	sqfs_dirs = (struct squashfs_dir_stream *)dirs;
-	free(sqfs_dirs->inode_table);
-	free(sqfs_dirs->dir_table);
 	free(sqfs_dirs->dir_header);
 	free(sqfs_dirs);
 }
@@ -29,6 +29,10 @@
 #define SQFS_EMPTY_FILE_SIZE 3
 #define SQFS_STOP_READDIR 1
 #define SQFS_EMPTY_DIR -1
+/* Number of decompressed fragment blocks kept per mount */
+#define SQFS_FRAG_CACHE_ENTRIES 4
+/* Upper bound of the data blocks fetched with a single device read */
+#define SQFS_DATA_BATCH_SIZE (1024 * 1024)
 /*
  * A directory entry object has a fixed length of 8 bytes, corresponding to its
  * first four members, plus the size of the entry name, which is equal to
@@ -73,6 +77,15 @@ struct squashfs_super_block {
 	__le64 export_table_start;
 };
 
+struct squashfs_frag_cache {
+	/* On-disk position of the fragment block, valid when 'data' is set */
+	u64 start;
+	/* Decompressed length of the fragment block */
+	u32 size;
+	unsigned int last_use;
+	char *data;
+};
+
 struct squashfs_ctxt {
 	struct disk_partition cur_part_info;
 	struct blk_desc *cur_dev;
@@ -80,6 +93,25 @@ struct squashfs_ctxt {
 #if IS_ENABLED(CONFIG_ZSTD)
 	void *zstd_workspace;
 #endif
+	/*
+	 * Device, hardware partition, partition and superblock the cached
+	 * tables and fragments were read from. The caches are kept across
+	 * sqfs_close() and dropped when another filesystem is probed or when
+	 * this one is written to, see sqfs_cache_invalidate().
+	 */
+	struct blk_desc *cache_dev;
+	int cache_hwpart;
+	lbaint_t cache_part_start;
+	lbaint_t cache_part_size;
+	struct squashfs_super_block cache_sblk;
+	/* Decompressed inode and directory tables, read on first use */
+	unsigned char *inode_table;
+	unsigned char *dir_table;
+	u32 *dir_pos_list;
+	int dir_metablks_count;
+	/* Least recently used fragment blocks are evicted first */
+	struct squashfs_frag_cache frag_cache[SQFS_FRAG_CACHE_ENTRIES];
+	unsigned int frag_cache_tick;
 };
 
 struct squashfs_directory_index {
@@ -274,7 +306,8 @@ struct squashfs_dir_stream {
 	struct squashfs_ldir_inode i_ldir;
 	/*
 	 * References to the tables' beginnings. They are assigned in
-	 * sqfs_opendir() and freed in sqfs_closedir().
+	 * sqfs_opendir() and belong to the mount context, which frees them in
+	 * sqfs_close().
 	 */
 	unsigned char *inode_table;
 	unsigned char *dir_table;
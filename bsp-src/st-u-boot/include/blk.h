@@ -83,6 +83,13 @@ struct blk_desc {
 	 * device. Once these functions are removed we can drop this field.
 	 */
 	struct udevice *bdev;
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	/* Asynchronous requests, the driver works on the first one */
+	struct blk_req	*async_head;
+	struct blk_req	*async_tail;
+	bool		async_busy;	/* async_head started by the driver */
+	bool		async_in_driver; /* driver starting/polling async_head */
+#endif
 #else
 	unsigned long	(*block_read)(struct blk_desc *block_dev,
 				      lbaint_t start,
@@ -202,6 +209,45 @@ static inline void blkcache_free(void) {}
 #if CONFIG_IS_ENABLED(BLK)
 struct udevice;
 
+enum blk_req_op {
+	BLK_REQ_READ,
+	BLK_REQ_WRITE,
+};
+
+/**
+ * struct blk_req - an asynchronous block device request
+ *
+ * Filled in by the caller of blk_submit(), except for @dev, @status and
+ * @next which belong to the uclass.
+ *
+ * @dev:	Block device the request was submitted to
+ * @op:		Operation to perform
+ * @start:	First block to transfer
+ * @blkcnt:	Number of blocks to transfer
+ * @buffer:	Data buffer, read from for writes. Drivers may only transfer
+ *		it asynchronously when its start and end are aligned to
+ *		ARCH_DMA_MINALIGN, as data sharing a cache line with it could
+ *		be lost; other requests are completed synchronously
+ * @status:	-EINPROGRESS until the request completes, then the number of
+ *		blocks transferred or a -ve error number
+ * @complete:	Called once the request completes, or NULL. It is called
+ *		from blk_submit(), blk_poll() or blk_wait() and may submit
+ *		new requests
+ * @priv:	Free for the caller, e.g. to find its context in @complete
+ * @next:	Next request queued on @dev
+ */
+struct blk_req {
+	struct udevice *dev;
+	enum blk_req_op op;
+	lbaint_t start;
+	lbaint_t blkcnt;
+	void *buffer;
+	long status;
+	void (*complete)(struct blk_req *req);
+	void *priv;
+	struct blk_req *next;
+};
+
 /* Operations on block devices */
 struct blk_ops {
 	/**
@@ -260,6 +306,32 @@ struct blk_ops {
 	 * @return 0 if OK, -ve on error
 	 */
 	int (*select_hwpart)(struct udevice *dev, int hwpart);
+
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	/**
+	 * submit() - start an asynchronous transfer
+	 *
+	 * The uclass only starts a request once the previous one on @dev
+	 * has completed, so drivers handle a single request at a time. It
+	 * stays in flight until poll() reports its end.
+	 *
+	 * @dev:	Block device
+	 * @req:	Request to start
+	 * @return 0 if started, -ENOSYS to have the uclass complete the
+	 * request synchronously, or other -ve error number
+	 */
+	int (*submit)(struct udevice *dev, struct blk_req *req);
+
+	/**
+	 * poll() - make progress on the request in flight
+	 *
+	 * @dev:	Block device
+	 * @req:	Request started by submit()
+	 * @return -EINPROGRESS while the transfer runs, then the number of
+	 * blocks transferred or another -ve error number
+	 */
+	long (*poll)(struct udevice *dev, struct blk_req *req);
+#endif
 };
 
 #define blk_get_ops(dev)	((struct blk_ops *)(dev)->driver->ops)
@@ -314,6 +386,41 @@ long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
  */
 long blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
 
+/**
+ * blk_submit() - Queue an asynchronous read or write
+ *
+ * Requests on a device are carried out and completed in submission order.
+ * Drivers without asynchronous support complete @req before this returns,
+ * so @req->complete may be called from here. Synchronous accesses to the
+ * device, e.g. blk_read(), first wait for all the queued requests.
+ *
+ * A write invalidates the block and partition caches when it is submitted.
+ *
+ * @dev:	Device to access
+ * @req:	Request, which must stay valid until it completes
+ * Return: 0 if queued or completed (see @req->status), -ve on error in
+ * which case @req is not queued
+ */
+int blk_submit(struct udevice *dev, struct blk_req *req);
+
+/**
+ * blk_poll() - Make progress on the asynchronous requests of a device
+ *
+ * Completion callbacks of finished requests are called from here.
+ *
+ * @dev:	Device to poll
+ * Return: number of requests still queued on @dev
+ */
+int blk_poll(struct udevice *dev);
+
+/**
+ * blk_wait() - Wait for an asynchronous request to complete
+ *
+ * @req:	Request passed to blk_submit()
+ * Return: number of blocks transferred, or -ve on error
+ */
+long blk_wait(struct blk_req *req);
+
 /**
  * blk_find_device() - Find a block device
  *
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Copyright (C) 2024, STMicroelectronics - All Rights Reserved
+ */
+
+#ifndef __CPU_JOB_H
+#define __CPU_JOB_H
+
+#include <linux/errno.h>
+
+#if CONFIG_IS_ENABLED(CPU_JOB)
+/**
+ * cpu_job_start() - start running a job on a secondary CPU
+ *
+ * Only one job can run at a time. The job runs concurrently with the boot
+ * CPU, so it must not use any U-Boot service which is not reentrant
+ * (console, malloc(), driver model, timers...): it may only work on memory
+ * prepared by the caller, who must not touch it until cpu_job_wait()
+ * returns.
+ *
+ * @fn:		function to run
+ * @arg:	argument passed to @fn
+ * Return: 0 if the job was started, -ENOSYS if no secondary CPU is
+ *	available or U-Boot does not run at EL2, in which case the caller
+ *	should run @fn itself, other -ve value on error
+ */
+int cpu_job_start(void (*fn)(void *arg), void *arg);
+
+/**
+ * cpu_job_wait() - wait for the end of the job started by cpu_job_start()
+ *
+ * The secondary CPU may still be powering off when this returns, in which
+ * case the next cpu_job_start() returns -EBUSY.
+ *
+ * Return: 0 once the job has completed, -ve on error
+ */
+int cpu_job_wait(void);
+#else
+static inline int cpu_job_start(void (*fn)(void *arg), void *arg)
+{
+	return -ENOSYS;
+}
+
+static inline int cpu_job_wait(void)
+{
+	return -ENOSYS;
+}
+#endif
+
+#endif /* __CPU_JOB_H */
@@ -542,6 +542,35 @@ struct dm_mmc_ops {
 	 * @return 0 if success, -ve on error
 	 */
 	int (*hs400_prepare_ddr)(struct udevice *dev);
+
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	/**
+	 * send_cmd_start() - Send a data command without waiting for the data
+	 *
+	 * Like send_cmd(), but returns once the command response is received
+	 * while the data transfer goes on. The transfer is then completed
+	 * with send_cmd_poll(), and no other command may be sent before.
+	 *
+	 * @dev:	Device to receive the command
+	 * @cmd:	Command to send
+	 * @data:	Data to send/receive
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*send_cmd_start)(struct udevice *dev, struct mmc_cmd *cmd,
+			      struct mmc_data *data);
+
+	/**
+	 * send_cmd_poll() - Check a transfer started by send_cmd_start()
+	 *
+	 * @dev:	Device the command was sent to
+	 * @cmd:	Command passed to send_cmd_start()
+	 * @data:	Data passed to send_cmd_start()
+	 * @return -EINPROGRESS while the data transfer runs, 0 once it has
+	 * completed, other -ve error number on failure
+	 */
+	int (*send_cmd_poll)(struct udevice *dev, struct mmc_cmd *cmd,
+			     struct mmc_data *data);
+#endif
 };
 
 #define mmc_get_ops(dev)        ((struct dm_mmc_ops *)(dev)->driver->ops)
@@ -559,6 +588,10 @@ int mmc_reinit(struct mmc *mmc);
 int mmc_get_b_max(struct mmc *mmc, void *dst, lbaint_t blkcnt);
 int mmc_hs400_prepare_ddr(struct mmc *mmc);
 int mmc_send_stop_transmission(struct mmc *mmc, bool write);
+int mmc_send_cmd_start(struct mmc *mmc, struct mmc_cmd *cmd,
+		       struct mmc_data *data);
+int mmc_send_cmd_poll(struct mmc *mmc, struct mmc_cmd *cmd,
+		      struct mmc_data *data);
 
 #else
 struct mmc_ops {
@@ -739,6 +772,12 @@ struct mmc {
 	u8 hs400_tuning;
 
 	enum bus_mode user_speed_mode; /* input speed mode from user */
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+	/* Data command in flight for an asynchronous block request */
+	struct mmc_cmd async_cmd;
+	struct mmc_data async_data;
+	lbaint_t async_done;	/* blocks of the request already done */
+#endif
 };
 
 #if CONFIG_IS_ENABLED(DM_MMC)
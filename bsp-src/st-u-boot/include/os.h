@@ -525,4 +525,22 @@ long os_get_time_offset(void);
  */
 void os_set_time_offset(long offset);
 
+/**
+ * os_job_start() - run a function in a new host thread
+ *
+ * Only one job can run at a time.
+ *
+ * @fn:		function to run
+ * @arg:	argument passed to @fn
+ * Return:	0 if OK, -1 on error
+ */
+int os_job_start(void (*fn)(void *arg), void *arg);
+
+/**
+ * os_job_wait() - wait for the end of the thread started by os_job_start()
+ *
+ * Return:	0 if OK, -1 on error
+ */
+int os_job_wait(void);
+
 #endif
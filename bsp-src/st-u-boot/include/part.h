@@ -398,6 +398,19 @@ struct part_driver {
 	int (*get_info)(struct blk_desc *dev_desc, int part,
 			struct disk_partition *info);
 
+	/**
+	 * @get_info_by_name:	Find a partition by name (optional)
+	 *
+	 * @get_info_by_name.dev_desc:	Block device descriptor
+	 * @get_info_by_name.name:	Partition name
+	 * @get_info_by_name.info:	Returns partition information
+	 * @get_info_by_name.Return:
+	 * partition number on match, -ENOENT on no match, -ENOSYS to fall
+	 * back to a search with @get_info, other -ve on error
+	 */
+	int (*get_info_by_name)(struct blk_desc *dev_desc, const char *name,
+				struct disk_partition *info);
+
 	/**
 	 * @print:		Print partition information
 	 *
@@ -420,6 +433,24 @@ struct part_driver {
 #define U_BOOT_PART_TYPE(__name)					\
 	ll_entry_declare(struct part_driver, __name, part_driver)
 
+#if CONFIG_IS_ENABLED(PARTITION_CACHE)
+/**
+ * part_cache_invalidate() - drop the cached partition table of a device
+ *
+ * Called for each write or erase of a block device. The cached table is
+ * dropped when the blocks hit the table itself.
+ *
+ * @dev_desc:	Block device descriptor
+ * @start:	First block written
+ * @blkcnt:	Number of blocks written
+ */
+void part_cache_invalidate(struct blk_desc *dev_desc, lbaint_t start,
+			   lbaint_t blkcnt);
+#else
+static inline void part_cache_invalidate(struct blk_desc *dev_desc,
+					 lbaint_t start, lbaint_t blkcnt) {}
+#endif
+
 #include <part_efi.h>
 
 #if CONFIG_IS_ENABLED(EFI_PARTITION)
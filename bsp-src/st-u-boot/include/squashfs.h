@@ -10,7 +10,11 @@
 #ifndef _SQFS_H_
 #define _SQFS_H_
 
+#include <blk.h>
+
 struct disk_partition;
+struct fs_dir_stream;
+struct fs_dirent;
 
 int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp);
 int sqfs_readdir(struct fs_dir_stream *dirs, struct fs_dirent **dentp);
@@ -23,4 +27,22 @@ int sqfs_exists(const char *filename);
 void sqfs_close(void);
 void sqfs_closedir(struct fs_dir_stream *dirs);
 
+#if CONFIG_IS_ENABLED(FS_SQUASHFS)
+/**
+ * sqfs_cache_invalidate() - drop the cached tables and fragments
+ *
+ * Called for each write or erase of a block device. The cache is dropped
+ * when the blocks hit the filesystem it was read from.
+ *
+ * @dev_desc:	Block device descriptor
+ * @start:	First block written
+ * @blkcnt:	Number of blocks written
+ */
+void sqfs_cache_invalidate(struct blk_desc *dev_desc, lbaint_t start,
+			   lbaint_t blkcnt);
+#else
+static inline void sqfs_cache_invalidate(struct blk_desc *dev_desc,
+					 lbaint_t start, lbaint_t blkcnt) {}
+#endif
+
 #endif /* SQFS_H  */
@@ -100,6 +100,9 @@ static void LZ4_wildCopy(void* dstPtr, const void* srcPtr, void* dstEnd)
 
 #define LZ4_STATIC_ASSERT(c)	BUILD_BUG_ON(!(c))
 
+/* copies at least this long are done with memcpy()/memmove() */
+#define LZ4_LONG_COPY	64
+
 /**************************************
 *  Local Structures and types
 **************************************/
@@ -338,8 +341,15 @@ static FORCE_INLINE int LZ4_decompress_generic(
 			if (!partialDecoding || (cpy == oend))
 				break;
 		} else {
-			/* may overwrite up to WILDCOPYLENGTH beyond cpy */
-			LZ4_wildCopy(op, ip, cpy);
+			/*
+			 * long runs go through the optimised memmove(), which
+			 * copes with in-place decompression; short ones may
+			 * overwrite up to WILDCOPYLENGTH beyond cpy
+			 */
+			if (length >= LZ4_LONG_COPY)
+				memmove(op, ip, length);
+			else
+				LZ4_wildCopy(op, ip, cpy);
 			ip += length;
 			op = cpy;
 		}
@@ -494,6 +504,10 @@ _copy_match:
 			}
 			while (op < cpy)
 				*op++ = *match++;
+		} else if (length >= LZ4_LONG_COPY &&
+			   (size_t)(op - match) >= (size_t)(cpy - op)) {
+			/* the rest of the match does not overlap the output */
+			memcpy(op, match, cpy - op);
 		} else {
 			LZ4_copy8(op, match);
 			if (length > 16)
@@ -205,9 +205,8 @@ void inflate_fast(z_streamp strm, unsigned start)
                         from += wsize - op;
                         if (op < len) {         /* some from window */
                             len -= op;
-                            do {
-                                PUP(out) = PUP(from);
-                            } while (--op);
+                            zmemcpy(out + OFF, from + OFF, op);
+                            out += op;
                             from = out - dist;  /* rest from output */
                         }
                     }
@@ -216,16 +215,14 @@ void inflate_fast(z_streamp strm, unsigned start)
                         op -= write;
                         if (op < len) {         /* some from end of window */
                             len -= op;
-                            do {
-                                PUP(out) = PUP(from);
-                            } while (--op);
+                            zmemcpy(out + OFF, from + OFF, op);
+                            out += op;
                             from = window - OFF;
                             if (write < len) {  /* some from start of window */
                                 op = write;
                                 len -= op;
-                                do {
-                                    PUP(out) = PUP(from);
-                                } while (--op);
+                                zmemcpy(out + OFF, from + OFF, op);
+                                out += op;
                                 from = out - dist;      /* rest from output */
                             }
                         }
@@ -234,9 +231,8 @@ void inflate_fast(z_streamp strm, unsigned start)
                         from += write - op;
                         if (op < len) {         /* some from window */
                             len -= op;
-                            do {
-                                PUP(out) = PUP(from);
-                            } while (--op);
+                            zmemcpy(out + OFF, from + OFF, op);
+                            out += op;
                             from = out - dist;  /* rest from output */
                         }
                     }
@@ -257,6 +253,30 @@ void inflate_fast(z_streamp strm, unsigned start)
 		    unsigned long loops;
 
                     from = out - dist;          /* copy direct from output */
+                    if (dist >= 8) {
+                        /*
+                         * No overlap within a word: copy 8 bytes at once,
+                         * rounding the length up. There are at least 258
+                         * bytes of room here, so the extra bytes stay in
+                         * the output buffer for matches up to 250 bytes.
+                         */
+                        unsigned char FAR *stop = out + len;
+
+                        if (len <= 250) {
+                            do {
+                                put_unaligned(get_unaligned((u64 *)(from + OFF)),
+                                              (u64 *)(out + OFF));
+                                from += 8;
+                                out += 8;
+                            } while (out < stop);
+                            out = stop;
+                        } else {
+                            do {
+                                PUP(out) = PUP(from);
+                            } while (out < stop);
+                        }
+                        continue;
+                    }
                     /* minimum length is three */
 		    /* Align out addr */
 		    if (!((long)(out - 1 + OFF) & 1)) {
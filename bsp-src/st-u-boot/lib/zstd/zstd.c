@@ -7,54 +7,179 @@
 
 #include <common.h>
 #include <abuf.h>
+#include <cpu_job.h>
 #include <log.h>
 #include <malloc.h>
 #include <linux/zstd.h>
 
+struct zstd_job {
+	zstd_dctx *ctx;
+	const void *src;
+	size_t src_size;
+	void *dst;
+	size_t dst_size;
+	size_t ret;
+};
+
+static void zstd_job_run(void *arg)
+{
+	struct zstd_job *job = arg;
+
+	job->ret = zstd_decompress_dctx(job->ctx, job->dst, job->dst_size,
+					job->src, job->src_size);
+}
+
+/**
+ * zstd_scan_frames() - find the frames to decompress
+ *
+ * Walk the frames at the start of @src, stopping at the first bytes which
+ * are not a frame: there may be junk after the last frame that
+ * zstd_decompress_dctx() can't handle.
+ *
+ * When there are several frames and all of them record their content size,
+ * also find the frame boundary nearest to the middle of the output, so that
+ * both halves can be decompressed independently.
+ *
+ * @src:	compressed data
+ * @size:	size of @src
+ * @split_in:	returns the offset of the boundary in @src, 0 if none
+ * @split_out:	returns the offset of the boundary in the output
+ * Return:	size of the frames, or zstd error code
+ */
+static size_t zstd_scan_frames(const void *src, size_t size, size_t *split_in,
+			       size_t *split_out)
+{
+	zstd_frame_header hdr;
+	size_t pos, len;
+	u64 total = 0, out, diff, best;
+	bool known = true;
+	int frames = 0;
+
+	for (pos = 0; pos < size; pos += len) {
+		len = zstd_find_frame_compressed_size(src + pos, size - pos);
+		if (zstd_is_error(len)) {
+			if (!pos)
+				return len;
+			break;
+		}
+		if (zstd_get_frame_header(&hdr, src + pos, size - pos) ||
+		    hdr.frameType != ZSTD_frame)
+			continue;
+		if (hdr.frameContentSize == ZSTD_CONTENTSIZE_UNKNOWN)
+			known = false;
+		else
+			total += hdr.frameContentSize;
+		frames++;
+	}
+	size = pos;
+
+	*split_in = 0;
+	*split_out = 0;
+	if (!known || frames < 2)
+		return size;
+
+	best = total;
+	for (pos = 0, out = 0; pos < size; pos += len) {
+		len = zstd_find_frame_compressed_size(src + pos, size - pos);
+		diff = total > 2 * out ? total - 2 * out : 2 * out - total;
+		if (pos && diff < best) {
+			best = diff;
+			*split_in = pos;
+			*split_out = out;
+		}
+		if (!zstd_get_frame_header(&hdr, src + pos, size - pos) &&
+		    hdr.frameType == ZSTD_frame)
+			out += hdr.frameContentSize;
+	}
+
+	return size;
+}
+
 int zstd_decompress(struct abuf *in, struct abuf *out)
 {
-	zstd_dctx *ctx;
-	size_t wsize, len;
+	struct zstd_job job[2];
+	size_t wsize, len, split_in, split_out;
 	void *workspace;
-	int ret;
+	bool split;
+	int ret, i;
+
+	len = zstd_scan_frames(abuf_data(in), abuf_size(in), &split_in,
+			       &split_out);
+	if (zstd_is_error(len)) {
+		log_err("%s: failed to detect compressed size: %d\n", __func__,
+			zstd_get_error_code(len));
+		return -EINVAL;
+	}
+
+	/*
+	 * Decompress the two halves of a multi-frame image concurrently when
+	 * a secondary CPU is available, with one context each.
+	 */
+	split = CONFIG_IS_ENABLED(CPU_JOB) && split_in &&
+		split_out <= abuf_size(out);
 
 	wsize = zstd_dctx_workspace_bound();
-	workspace = malloc(wsize);
+	workspace = malloc(wsize * (split ? 2 : 1));
 	if (!workspace) {
 		debug("%s: cannot allocate workspace of size %zu\n", __func__,
 			wsize);
 		return -ENOMEM;
 	}
 
-	ctx = zstd_init_dctx(workspace, wsize);
-	if (!ctx) {
-		log_err("%s: zstd_init_dctx() failed\n", __func__);
-		ret = -EPERM;
-		goto do_free;
+	for (i = 0; i < (split ? 2 : 1); i++) {
+		job[i].ctx = zstd_init_dctx(workspace + i * wsize, wsize);
+		if (!job[i].ctx) {
+			log_err("%s: zstd_init_dctx() failed\n", __func__);
+			ret = -EPERM;
+			goto do_free;
+		}
 	}
 
-	/*
-	 * Find out how large the frame actually is, there may be junk at
-	 * the end of the frame that zstd_decompress_dctx() can't handle.
-	 */
-	len = zstd_find_frame_compressed_size(abuf_data(in), abuf_size(in));
-	if (zstd_is_error(len)) {
-		log_err("%s: failed to detect compressed size: %d\n", __func__,
-			zstd_get_error_code(len));
-		ret = -EINVAL;
-		goto do_free;
+	job[0].src = abuf_data(in);
+	job[0].src_size = len;
+	job[0].dst = abuf_data(out);
+	job[0].dst_size = abuf_size(out);
+	if (split) {
+		job[0].src_size = split_in;
+		job[0].dst_size = split_out;
+		job[1].src = abuf_data(in) + split_in;
+		job[1].src_size = len - split_in;
+		job[1].dst = abuf_data(out) + split_out;
+		job[1].dst_size = abuf_size(out) - split_out;
+
+		if (cpu_job_start(zstd_job_run, &job[1])) {
+			zstd_job_run(&job[0]);
+			zstd_job_run(&job[1]);
+		} else {
+			zstd_job_run(&job[0]);
+			if (cpu_job_wait()) {
+				log_err("%s: secondary CPU failed\n", __func__);
+				ret = -EIO;
+				goto do_free;
+			}
+		}
+	} else {
+		zstd_job_run(&job[0]);
 	}
 
-	len = zstd_decompress_dctx(ctx, abuf_data(out), abuf_size(out),
-				   abuf_data(in), len);
-	if (zstd_is_error(len)) {
-		log_err("%s: failed to decompress: %d\n", __func__,
-			zstd_get_error_code(len));
-		ret = -EINVAL;
-		goto do_free;
+	for (i = 0; i < (split ? 2 : 1); i++) {
+		if (zstd_is_error(job[i].ret)) {
+			log_err("%s: failed to decompress: %d\n", __func__,
+				zstd_get_error_code(job[i].ret));
+			ret = -EINVAL;
+			goto do_free;
+		}
 	}
 
-	ret = len;
+	ret = job[0].ret;
+	if (split) {
+		if (job[0].ret != split_out) {
+			log_err("%s: frame content size mismatch\n", __func__);
+			ret = -EINVAL;
+			goto do_free;
+		}
+		ret += job[1].ret;
+	}
 do_free:
 	free(workspace);
 	return ret;
@@ -12,8 +12,10 @@
 #include <log.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <time.h>
 #include <asm/io.h>
 
+#include <u-boot/crc.h>
 #include <u-boot/lz4.h>
 #include <u-boot/zlib.h>
 #include <bzlib.h>
@@ -23,6 +25,7 @@
 #include <lzma/LzmaTools.h>
 
 #include <linux/lzo.h>
+#include <linux/sizes.h>
 #include <linux/zstd.h>
 #include <test/compression.h>
 #include <test/suites.h>
@@ -508,6 +511,29 @@ static int compression_test_zstd(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_zstd, 0);
 
+/* Several frames, as written by pzstd, followed by padding */
+static int compression_test_zstd_frames(struct unit_test_state *uts)
+{
+	const unsigned long plain_size = strlen(plain);
+	char in[2 * sizeof(zstd_compressed) + 16];
+	char out[2 * sizeof(plain)];
+	unsigned long in_size, out_size;
+
+	memset(in, '\0', sizeof(in));
+	memcpy(in, zstd_compressed, zstd_compressed_size);
+	memcpy(in + zstd_compressed_size, zstd_compressed, zstd_compressed_size);
+	in_size = 2 * zstd_compressed_size + 16;
+
+	ut_assertok(uncompress_using_zstd(uts, in, in_size, out, sizeof(out),
+					  &out_size));
+	ut_asserteq(2 * plain_size, out_size);
+	ut_asserteq_mem(plain, out, plain_size);
+	ut_asserteq_mem(plain, out + plain_size, plain_size);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_zstd_frames, 0);
+
 static int compress_using_none(struct unit_test_state *uts,
 			       void *in, unsigned long in_size,
 			       void *out, unsigned long out_max,
@@ -610,6 +636,127 @@ static int compression_test_bootm_none(struct unit_test_state *uts)
 }
 COMPRESSION_TEST(compression_test_bootm_none, 0);
 
+#define SPEED_TEST_SIZE		SZ_1M
+
+static ulong speed_test_rand(ulong *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+
+	return *seed >> 16;
+}
+
+/* Print the throughput of a decoder, in MB/s */
+static void speed_test_report(const char *name, ulong size, ulong us)
+{
+	printf("%s: %lu bytes in %lu us (%lu MB/s)\n", name, size, us,
+	       us ? size / us : 0);
+}
+
+/*
+ * Write an LZ4 block made of random literal runs and matches, with long
+ * runs and overlapping matches, and the data it decodes to in @plain.
+ * Return the size of the block, and the size of the data in @plain_size.
+ */
+static ulong speed_test_lz4_block(u8 *block, u8 *plain, ulong size,
+				  ulong *plain_size)
+{
+	ulong seed = 1, in = 0, out = 0, lit, offset, mlen, n, i;
+
+	while (out + 600 < size) {
+		lit = speed_test_rand(&seed) % 200;
+		if (!out && !lit)
+			lit = 1;
+		offset = 1 + speed_test_rand(&seed) % min(out + lit, 65535UL);
+		mlen = 4 + speed_test_rand(&seed) % 300;
+
+		block[in++] = min(lit, 15UL) << 4 | min(mlen - 4, 15UL);
+		if (lit >= 15) {
+			for (n = lit - 15; n >= 255; n -= 255)
+				block[in++] = 255;
+			block[in++] = n;
+		}
+		for (i = 0; i < lit; i++)
+			plain[out++] = block[in++] = speed_test_rand(&seed) % 64;
+		block[in++] = offset & 0xff;
+		block[in++] = offset >> 8;
+		if (mlen - 4 >= 15) {
+			for (n = mlen - 4 - 15; n >= 255; n -= 255)
+				block[in++] = 255;
+			block[in++] = n;
+		}
+		for (i = 0; i < mlen; i++, out++)
+			plain[out] = plain[out - offset];
+	}
+
+	/* the block ends with literals */
+	block[in++] = 15 << 4;
+	block[in++] = 64 - 15;
+	for (i = 0; i < 64; i++)
+		plain[out++] = block[in++] = i;
+	*plain_size = out;
+
+	return in;
+}
+
+static int compression_test_speed(struct unit_test_state *uts)
+{
+	const ulong plain_size = strlen(plain);
+	u8 *data, *comp, *out;
+	ulong seed = 1, size, comp_size, len, pos, start;
+	u32 crc, ref;
+	int i;
+
+	data = malloc(SPEED_TEST_SIZE);
+	comp = malloc(2 * SPEED_TEST_SIZE);
+	out = malloc(SPEED_TEST_SIZE);
+	ut_assertnonnull(data);
+	ut_assertnonnull(comp);
+	ut_assertnonnull(out);
+
+	/* Text-like data with matches at all distances */
+	for (size = 0; size < SPEED_TEST_SIZE; size += len) {
+		pos = speed_test_rand(&seed) % plain_size;
+		len = min(plain_size - pos, SPEED_TEST_SIZE - size);
+		len = min(len, 1 + speed_test_rand(&seed) % 64);
+		memcpy(data + size, plain + pos, len);
+	}
+
+	comp_size = 2 * SPEED_TEST_SIZE;
+	ut_assertok(gzip(comp, &comp_size, data, SPEED_TEST_SIZE));
+	len = comp_size;
+	start = timer_get_us();
+	ut_assertok(gunzip(out, SPEED_TEST_SIZE, comp, &len));
+	speed_test_report("gunzip", len, timer_get_us() - start);
+	ut_asserteq(SPEED_TEST_SIZE, len);
+	ut_asserteq_mem(data, out, SPEED_TEST_SIZE);
+
+	start = timer_get_us();
+	crc = crc32(0, data + 1, SPEED_TEST_SIZE - 1);
+	speed_test_report("crc32", SPEED_TEST_SIZE, timer_get_us() - start);
+	ref = ~0U;
+	for (len = 1; len < SPEED_TEST_SIZE; len++) {
+		ref ^= data[len];
+		for (i = 0; i < 8; i++)
+			ref = ref >> 1 ^ (ref & 1 ? 0xedb88320 : 0);
+	}
+	ut_asserteq(~ref, crc);
+
+	comp_size = speed_test_lz4_block(comp, data, SPEED_TEST_SIZE, &size);
+	start = timer_get_us();
+	len = LZ4_decompress_safe((char *)comp, (char *)out, comp_size,
+				  SPEED_TEST_SIZE);
+	speed_test_report("lz4", len, timer_get_us() - start);
+	ut_asserteq(size, len);
+	ut_asserteq_mem(data, out, size);
+
+	free(out);
+	free(comp);
+	free(data);
+
+	return 0;
+}
+COMPRESSION_TEST(compression_test_speed, 0);
+
 int do_ut_compression(struct cmd_tbl *cmdtp, int flag, int argc,
 		      char *const argv[])
 {
@@ -5,11 +5,13 @@
 
 #include <common.h>
 #include <dm.h>
+#include <memalign.h>
 #include <part.h>
 #include <sandbox_host.h>
 #include <usb.h>
 #include <asm/global_data.h>
 #include <asm/state.h>
+#include <asm/test.h>
 #include <dm/test.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -334,3 +336,94 @@ static int dm_test_blk_foreach(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_blk_foreach, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+#if CONFIG_IS_ENABLED(BLK_ASYNC)
+static int blk_async_seq;
+
+static void blk_async_complete(struct blk_req *req)
+{
+	*(int *)req->priv = ++blk_async_seq;
+}
+
+/* Test queueing asynchronous requests on an MMC device */
+static int dm_test_blk_async(struct unit_test_state *uts)
+{
+	struct blk_req wr, rd, bad;
+	struct blk_desc *desc;
+	struct udevice *dev;
+	ALLOC_CACHE_ALIGN_BUFFER(char, out, 4 * 512);
+	ALLOC_CACHE_ALIGN_BUFFER(char, in, 4 * 512);
+	int wr_seq = 0, rd_seq = 0, bad_seq = 0;
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_BLK, "mmc2.blk", &dev));
+	desc = dev_get_uclass_plat(dev);
+	memset(out, 0xa5, 4 * 512);
+	memset(in, '\0', 4 * 512);
+	blk_async_seq = 0;
+
+	wr = (struct blk_req){
+		.op = BLK_REQ_WRITE, .start = 10, .blkcnt = 4, .buffer = out,
+		.complete = blk_async_complete, .priv = &wr_seq,
+	};
+	rd = (struct blk_req){
+		.op = BLK_REQ_READ, .start = 10, .blkcnt = 4, .buffer = in,
+		.complete = blk_async_complete, .priv = &rd_seq,
+	};
+	bad = (struct blk_req){
+		.op = BLK_REQ_READ, .start = desc->lba, .blkcnt = 1,
+		.buffer = in, .complete = blk_async_complete, .priv = &bad_seq,
+	};
+
+	/* Nothing happens until the device is polled */
+	ut_assertok(blk_submit(dev, &wr));
+	ut_assertok(blk_submit(dev, &rd));
+	ut_asserteq(-EINPROGRESS, wr.status);
+	ut_asserteq(-EINPROGRESS, rd.status);
+	ut_asserteq(0, wr_seq);
+
+	/* Requests complete in order and the read sees the write */
+	ut_asserteq(4, blk_wait(&rd));
+	ut_asserteq(4, wr.status);
+	ut_asserteq(1, wr_seq);
+	ut_asserteq(2, rd_seq);
+	ut_asserteq_mem(out, in, 4 * 512);
+	ut_asserteq(0, blk_poll(dev));
+
+	/* Synchronous accesses wait for the queued requests */
+	wr.start = 20;
+	ut_assertok(blk_submit(dev, &wr));
+	ut_asserteq(-EINPROGRESS, wr.status);
+	ut_asserteq(4, blk_read(dev, 20, 4, in));
+	ut_asserteq(4, wr.status);
+	ut_asserteq(3, wr_seq);
+	ut_asserteq_mem(out, in, 4 * 512);
+
+	/* A buffer which is not cache-aligned is transferred right away */
+	rd.start = 20;
+	rd.blkcnt = 1;
+	rd.buffer = in + 1;
+	ut_assertok(blk_submit(dev, &rd));
+	ut_asserteq(1, rd.status);
+	ut_asserteq(4, rd_seq);
+	ut_asserteq_mem(out, in + 1, 512);
+
+	/* A failed transfer is completed by the synchronous path */
+	memset(in, '\0', 4 * 512);
+	rd.start = 20;
+	rd.blkcnt = 4;
+	rd.buffer = in;
+	sandbox_mmc_set_async_errors(dev_get_parent(dev), 1);
+	ut_assertok(blk_submit(dev, &rd));
+	ut_asserteq(4, blk_wait(&rd));
+	ut_asserteq(5, rd_seq);
+	ut_asserteq_mem(out, in, 4 * 512);
+
+	/* Errors are reported through the request */
+	ut_assertok(blk_submit(dev, &bad));
+	ut_asserteq(-EINVAL, blk_wait(&bad));
+	ut_asserteq(6, bad_seq);
+
+	return 0;
+}
+DM_TEST(dm_test_blk_async, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
@@ -195,3 +195,56 @@ static int dm_test_part_get_info_by_type(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_part_get_info_by_type, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+static int dm_test_part_get_info_by_name(struct unit_test_state *uts)
+{
+	char str_disk_guid[UUID_STR_LEN + 1];
+	struct blk_desc *mmc_dev_desc;
+	struct disk_partition info;
+	struct disk_partition parts[] = {
+		{
+			.start = 48, /* GPT data takes up the first 34 blocks or so */
+			.size = 1,
+			.name = "test1",
+		},
+		{
+			.start = 49,
+			.size = 1,
+			.name = "test2",
+		},
+		{
+			.start = 50,
+			.size = 1,
+			.name = "test2",
+		},
+	};
+
+	ut_asserteq(2, blk_get_device_by_str("mmc", "2", &mmc_dev_desc));
+	if (CONFIG_IS_ENABLED(RANDOM_UUID)) {
+		gen_rand_uuid_str(parts[0].uuid, UUID_STR_FORMAT_STD);
+		gen_rand_uuid_str(parts[1].uuid, UUID_STR_FORMAT_STD);
+		gen_rand_uuid_str(parts[2].uuid, UUID_STR_FORMAT_STD);
+		gen_rand_uuid_str(str_disk_guid, UUID_STR_FORMAT_STD);
+	}
+	ut_assertok(gpt_restore(mmc_dev_desc, str_disk_guid, parts,
+				ARRAY_SIZE(parts)));
+
+	ut_asserteq(1, part_get_info_by_name(mmc_dev_desc, "test1", &info));
+	ut_asserteq(48, info.start);
+	/* The first of two partitions with the same name wins */
+	ut_asserteq(2, part_get_info_by_name(mmc_dev_desc, "test2", &info));
+	ut_asserteq(49, info.start);
+	ut_asserteq(-ENOENT, part_get_info_by_name(mmc_dev_desc, "test", &info));
+
+	/* Rewriting the table must not leave stale names behind */
+	strcpy((char *)parts[0].name, "test3");
+	ut_assertok(gpt_restore(mmc_dev_desc, str_disk_guid, parts,
+				ARRAY_SIZE(parts)));
+	ut_asserteq(-ENOENT, part_get_info_by_name(mmc_dev_desc, "test1",
+						   &info));
+	ut_asserteq(1, part_get_info_by_name(mmc_dev_desc, "test3", &info));
+	ut_asserteq(48, info.start);
+
+	return 0;
+}
+DM_TEST(dm_test_part_get_info_by_name, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
@@ -161,6 +161,29 @@ def erofs_load_files_at_symlink(u_boot_console):
     address = '$kernel_addr_r'
     erofs_load_files(u_boot_console, files, sizes, address)
 
+def erofs_load_file_part(u_boot_console):
+    """
+    Test load a part of a compressed file, starting and ending within
+    compressed extents.
+    """
+    build_dir = u_boot_console.config.build_dir
+    address = '$kernel_addr_r'
+    file = 'f7812'
+    size = 1024
+    offset = 3000
+    out = u_boot_console.run_command('erofsload host 0 {} {} {} {}'.format(
+        address, file, hex(size), hex(offset)))
+    assert str(size) in out
+
+    out = u_boot_console.run_command('md5sum {} {}'.format(address, hex(size)))
+    u_boot_checksum = out.split()[-1]
+
+    original_file_path = os.path.join(build_dir, EROFS_SRC_DIR + '/' + file)
+    out = subprocess.run(['tail -c +{} {} | head -c {} | md5sum'.format(
+                          offset + 1, original_file_path, size)],
+                         shell=True, check=True, capture_output=True, text=True)
+    assert u_boot_checksum == out.stdout.split()[0]
+
 def erofs_load_non_existent_file(u_boot_console):
     """
     Test if the EROFS support will crash when load a nonexistent file.
@@ -181,6 +204,7 @@ def erofs_run_all_tests(u_boot_console):
     erofs_load_files_at_root(u_boot_console)
     erofs_load_files_at_subdir(u_boot_console)
     erofs_load_files_at_symlink(u_boot_console)
+    erofs_load_file_part(u_boot_console)
     erofs_load_non_existent_file(u_boot_console)
 
 @pytest.mark.boardspec('sandbox')
@@ -79,6 +79,27 @@ def generate_file(file_name, file_size):
     file.write(content)
     file.close()
 
+def generate_numbered_file(file_name, file_size):
+    """ Generates a file made of numbered lines.
+
+    Unlike generate_file(), every block of the file has a different content,
+    so that a block read at the wrong place is detected.
+
+    Args:
+        file_name: the file's name.
+        file_size: the content's length and therefore the file size.
+    """
+    lines = []
+    length = 0
+    while length < file_size:
+        line = '{:015d}\n'.format(len(lines))
+        lines.append(line)
+        length += len(line)
+
+    file = open(file_name, 'w')
+    file.write(''.join(lines)[:file_size])
+    file.close()
+
 def generate_sqfs_src_dir(build_dir):
     """ Generates the source directory used to make the SquashFS images.
 
@@ -88,12 +109,13 @@ def generate_sqfs_src_dir(build_dir):
     ├── empty-dir/
     ├── f1000
     ├── f4096
+    ├── f400000
     ├── f5096
     ├── subdir/
     │   └── subdir-file
     └── sym -> subdir
 
-    3 directories, 4 files
+    3 directories, 5 files
 
     The files in the root dir. are prefixed with an 'f' followed by its size.
 
@@ -117,6 +139,11 @@ def generate_sqfs_src_dir(build_dir):
     file_name = 'f1000'
     generate_file(os.path.join(root, file_name), 1000)
 
+    # 400000: several data blocks of the default block size (128K) and a
+    # fragment
+    file_name = 'f400000'
+    generate_numbered_file(os.path.join(root, file_name), 400000)
+
     # sub-directory with a single file inside
     subdir_path = os.path.join(root, 'subdir')
     os.makedirs(subdir_path)
@@ -73,8 +73,8 @@ def sqfs_load_files_at_root(u_boot_console):
         u_boot_console: provides the means to interact with U-Boot's console.
     """
 
-    files = ['f4096', 'f5096', 'f1000']
-    sizes = ['4096', '5096', '1000']
+    files = ['f4096', 'f5096', 'f1000', 'f400000']
+    sizes = ['4096', '5096', '1000', '400000']
     address = '$kernel_addr_r'
     sqfs_load_files(u_boot_console, files, sizes, address)
 
@@ -92,6 +92,29 @@ def sqfs_load_files_at_subdir(u_boot_console):
     address = '$kernel_addr_r'
     sqfs_load_files(u_boot_console, files, sizes, address)
 
+def sqfs_load_partial_file(u_boot_console):
+    """ Loads the beginning of a file and asserts its checksum.
+
+    The requested length ends in the middle of the first data block, which is
+    then decompressed aside before being copied.
+
+    Args:
+        u_boot_console: provides the means to interact with U-Boot's console.
+    """
+    build_dir = u_boot_console.config.build_dir
+    address = '$kernel_addr_r'
+    file = 'f5096'
+    size = 2000
+    out = u_boot_console.run_command('sqfsload host 0 {} {} {}'.format(
+        address, file, hex(size)))
+    assert str(size) in out
+
+    u_boot_checksum = uboot_md5sum(u_boot_console, address, hex(size))
+    original_file_path = os.path.join(build_dir, SQFS_SRC_DIR + '/' + file)
+    out = subprocess.run(['head -c {} {} | md5sum'.format(size, original_file_path)],
+                         shell=True, check=True, capture_output=True, text=True)
+    assert u_boot_checksum == out.stdout.split()[0]
+
 def sqfs_load_non_existent_file(u_boot_console):
     """ Calls sqfs_load_files passing an non-existent file to raise an error.
 
@@ -114,6 +137,7 @@ def sqfs_run_all_load_tests(u_boot_console):
     """
     sqfs_load_files_at_root(u_boot_console)
     sqfs_load_files_at_subdir(u_boot_console)
+    sqfs_load_partial_file(u_boot_console)
     sqfs_load_non_existent_file(u_boot_console)
 
 @pytest.mark.boardspec('sandbox')
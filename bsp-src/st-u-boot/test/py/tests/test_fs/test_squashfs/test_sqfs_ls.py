@@ -25,7 +25,8 @@ def sqfs_ls_at_root(u_boot_console):
     assert no_slash == slash
 
     expected_lines = ['empty-dir/', '1000   f1000', '4096   f4096', '5096   f5096',
-                      'subdir/', '<SYM>   sym', '4 file(s), 2 dir(s)']
+                      '400000   f400000', 'subdir/', '<SYM>   sym',
+                      '5 file(s), 2 dir(s)']
 
     output = u_boot_console.run_command('sqfsls host 0')
     for line in expected_lines: